@@ -6,8 +6,10 @@
 #include "fauxmoESP.h"
 #include "const.h"
 #include "simple_param.h"
+#include "param_store.h"
 #include "files.h"
 #include "mtr86.h"
+#include "mqtt_queue.h"
 
 extern fauxmoESP fauxmo;
 void initAlexa();
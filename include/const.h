@@ -6,6 +6,13 @@
 #define PRODUCT_DEVICE
 #define ES32A08
 #define ENABLE_WATCHDOG
+// Cycle entrées/logique locale/sorties dans une tâche dédiée (scan.h)
+// Plateforme native (NATIVE) : un seul fil d'exécution, cycle appelé par loop()
+#ifndef NATIVE
+#define SCAN_TASK
+// Enregistrement différé des paramètres dans une tâche dédiée (param_store.h)
+#define PERSIST_TASK
+#endif
 #ifdef  PRODUCT_DEVICE
 #define TOPIC_PREFIX ""
 #ifdef ES32A08
@@ -25,13 +32,11 @@
 
 // Décommenter les conditions d'exécution désirées
 //------------------------------------------------
-// #define EXEC_TIME_MEASURE
 
 // Versions à générer
 // #define DEBUG_OUTPUT
 // #define DEBUG_OUTPUT_LOOP2
 // #define DEBUG_OUTPUT_SCHEDULE
-// #define TIME_SIMULATOR
 // #define WEB_SERIAL
 // #define DEBUG_HEAP
 // #define DEBUG_TOPIC
@@ -42,7 +47,17 @@
 #define FORCE_GLOBAL_SCHEDULED_PARAM false
 #define FORCE_PERSISTANT_PARAM false
 #define FORCE_LOGS false
-#define MAX_LOG_SIZE 2048
+// Journal circulaire (log_store.h) : LOG_SEGMENTS fichiers de LOG_SEGMENT_SIZE octets
+#define LOG_SEGMENTS 8
+#define LOG_SEGMENT_SIZE 2048
+// Budget d'écriture flash : au-delà (écritures de la dernière heure, tous
+// fichiers), les logs ne sont plus écrits. Modifiable par TOPIC_SET_FLASH_BUDGET
+#define FLASH_WRITE_BUDGET 120
+#define FLASH_MIN_BUDGET   10
+// Enregistrement des compteurs d'écritures flash
+#define INTERVAL_FLASH_STATS_SAVE (60*60*1000UL)
+// Ecriture en mémoire flash des logs en cache (descripteur d'ajout ouvert)
+#define INTERVAL_FILE_SYNC (60*1000UL)
 
 // Taille max des packet MQTT 
 // #define MQTT_MAX_BUFFER_SIZE 512
@@ -53,6 +68,15 @@
 #ifdef WIFI_MANAGER
 #define SSID_AP   "Esp32HomeCtrl"
 #endif
+// Adresse fixe (réservée sur le routeur), sinon DHCP (wifi_cache.h)
+// #define WIFI_STATIC_IP      192, 168, 1, 50
+// #define WIFI_STATIC_GATEWAY 192, 168, 1, 1
+// #define WIFI_STATIC_SUBNET  255, 255, 255, 0
+// #define WIFI_STATIC_DNS     192, 168, 1, 1
+// Attente de la connexion directe au point d'accès mémorisé avant recherche complète
+#define WIFI_DIRECT_TIMEOUT (3*1000)
+// Réutilisation d'un bail DHCP après un redémarrage logiciel (s)
+#define WIFI_LEASE_REUSE (12*3600UL)
 
 // #define  CONFIG_ARDUINO_LOOP_STACK_SIZE 2*8192
 //-------------- Délais monostables ------------------------------
@@ -92,18 +116,32 @@ const int MAX_PAS_PERIODE_DEBIT = (PERIODE_DEBIT / PAS_PERIODE_DEBIT);
 // Délai des appels dans loop en ms
 #define INTERVAL_PORT_READ  1000
 #define INTERVAL_IO_SCRUT   100
+// Tâche de scrutation : loop() (réseau, LCD) tourne sur le coeur 1
+#define SCAN_TASK_CORE      0
+#define SCAN_TASK_PRIORITY  5
+#define SCAN_TASK_STACK     8192
+// Tâche d'enregistrement différé des paramètres, priorité basse
+#define PERSIST_TASK_CORE     1
+#define PERSIST_TASK_PRIORITY 1
+#define PERSIST_TASK_STACK    4096
+#define INTERVAL_PERSIST_POLL 200
+// Fenêtre de regroupement des écritures des paramètres simples (ms)
+#define PERSIST_WINDOW (5*1000)
 #define INTERVAL_RESET_WDT  200
 #define INTERVAL_ROTATE_DISPLAY  500
 #define INTERVAL_ROTATARY_SCHEDULE 10
 #define INTERVAL_IR_SEND (15*1000)
 #define INTERVAL_WIFI_TEST (10*60*10000)
 #define INTERVAL_WIFI_STRENG_SEND (30*1000)
-#define INTERVAL_MQTT_CONNECT_TEST (5*1000)
-#ifdef TIME_SIMULATOR
-#define INTERVAL_SCHEDULE 100
-#else
-#define INTERVAL_SCHEDULE (60*1000)
-#endif
+// Reconnexion WiFi / MQTT (net_link.h) : délai entre tentatives doublé à chaque échec
+#define NET_BACKOFF_MIN (1*1000)
+#define NET_BACKOFF_MAX (2*60*1000)
+// Attente de la connexion WiFi après WiFi.begin()
+#define NET_WIFI_TIMEOUT (15*1000)
+// Attente des réponses du courtier (s)
+#define NET_SOCKET_TIMEOUT 2
+// Scrutation du changement de minute de l'horloge (appel de schedule())
+#define INTERVAL_SCHEDULE 1000
 
 //----------------------------
 // Modes de fonctionnement VMC
@@ -173,6 +211,15 @@ const int MAX_PAS_PERIODE_DEBIT = (PERIODE_DEBIT / PAS_PERIODE_DEBIT);
 #define LATCH_955 GPIO_NUM_14
 #define NOE_955   GPIO_NUM_4
 #define DATA_955  GPIO_NUM_13
+
+// Pilote des registres à décalage 74HC595/74HC165 (choix à la compilation)
+// Par défaut : bit-bang des GPIO
+// IO_BACKEND_SPI  : périphériques SPI de l'ESP32 (HSPI -> 74HC595, VSPI -> 74HC165)
+// IO_BACKEND_MOCK : registres simulés en mémoire (tests hors cible)
+// #define IO_BACKEND_SPI
+// #define IO_BACKEND_MOCK
+// Fréquence d'horloge SPI des registres (Hz)
+#define IO_SPI_CLOCK 1000000
 #endif
 
 // Commande sur gpio
@@ -258,10 +305,20 @@ const int MAX_PAS_PERIODE_DEBIT = (PERIODE_DEBIT / PAS_PERIODE_DEBIT);
 #define TOPIC_MQTT_TEST       TOPIC_PREFIX "homecontrol/mqtt_test" 
 #define TOPIC_MQTT_GET_STATUS TOPIC_PREFIX "homecontrol/devices/get_status"
 #define TOPIC_APP_CONNECT     TOPIC_PREFIX "homecontrol/app_connect"
+#define TOPIC_GET_NEXT_EVENT  TOPIC_PREFIX "homecontrol/next_event_get"
+#define TOPIC_GET_IO_STATS    TOPIC_PREFIX "homecontrol/io_stats_get"
+#define TOPIC_GET_SCAN_STATS  TOPIC_PREFIX "homecontrol/scan_stats_get"
+#define TOPIC_GET_PROFILE     TOPIC_PREFIX "homecontrol/profile_get"
+#define TOPIC_GET_PARAM_SCHEMA TOPIC_PREFIX "homecontrol/param_schema_get"
+#define TOPIC_GET_FLASH_STATS TOPIC_PREFIX "homecontrol/flash_stats_get"
+#define TOPIC_SET_FLASH_BUDGET TOPIC_PREFIX "homecontrol/flash_budget"
+#define TOPIC_GET_MQTT_STATS  TOPIC_PREFIX "homecontrol/mqtt_stats_get"
+#define TOPIC_GET_NET_STATS   TOPIC_PREFIX "homecontrol/net_stats_get"
 
 //-------------Publications--------------------
 #define TOPIC_READ_VERSION   TOPIC_PREFIX  "homecontrol/readVersion"
 #define TOPIC_READ_LOGS      TOPIC_PREFIX  "homecontrol/readLogs"
+#define TOPIC_LOGS_SEQ       TOPIC_PREFIX  "homecontrol/logs_seq"
 #define TOPIC_PARAM          TOPIC_PREFIX  "homecontrol/param"
 #define TOPIC_DLY_PARAM      TOPIC_PREFIX  "homecontrol/dly_param"
 #define TOPIC_GPIO           TOPIC_PREFIX  "homecontrol/gpio"
@@ -274,6 +331,14 @@ const int MAX_PAS_PERIODE_DEBIT = (PERIODE_DEBIT / PAS_PERIODE_DEBIT);
 #define TOPIC_STATUS_WATERING TOPIC_PREFIX  "homecontrol/watering_status"
 #define TOPIC_STATUS_VMC                   "homecontrol/vmc_status"
 #define TOPIC_STATUS_PAC                   "homecontrol/pac_status"
+#define TOPIC_NEXT_EVENT     TOPIC_PREFIX  "homecontrol/next_event"
+#define TOPIC_IO_STATS       TOPIC_PREFIX  "homecontrol/io_stats"
+#define TOPIC_SCAN_STATS     TOPIC_PREFIX  "homecontrol/scan_stats"
+#define TOPIC_PROFILE        TOPIC_PREFIX  "homecontrol/profile"
+#define TOPIC_PARAM_SCHEMA   TOPIC_PREFIX  "homecontrol/param_schema"
+#define TOPIC_FLASH_STATS    TOPIC_PREFIX  "homecontrol/flash_stats"
+#define TOPIC_MQTT_STATS     TOPIC_PREFIX  "homecontrol/mqtt_stats"
+#define TOPIC_NET_STATS      TOPIC_PREFIX  "homecontrol/net_stats"
 //-------------Publications pour l'appli circuit2 (carte déportée irrigation) ---
 #define SUB_GPIO0_ACTION     TOPIC_PREFIX  "circuit2/action"
 
@@ -291,38 +356,37 @@ const int MAX_PAS_PERIODE_DEBIT = (PERIODE_DEBIT / PAS_PERIODE_DEBIT);
 #define WDT_TIMEOUT 100
 
 // Nom des fichiers
-// Paramétres des cycles programmés sur 24H 
-#define PARAM_FILE_NAME "/param.txt"
-// Logs
+// Paramétres des cycles programmés sur 24H (enregistrements binaires, param_store.h)
+#define PARAM_FILE_NAME "/param.bin"
+// Logs : segments du journal circulaire, ancien fichier texte (converti au démarrage)
+#define LOG_SEGMENT_NAME "/log%d.bin"
 #define LOG_FILE_NAME   "/logs.txt"
 // Paramétres des temporistions
-#define DLY_PARAM_FILE_NAME "/dlyParam.txt"
+#define DLY_PARAM_FILE_NAME "/dlyParam.bin"
 // Paramétres des autorisation des cycles programmés
-#define GLOBAL_SCHEDULED_PARAM_FILE_NAME "/globalScheduled.txt"
+#define GLOBAL_SCHEDULED_PARAM_FILE_NAME "/globalScheduled.bin"
 // Fichier des données persistantes
-#define FILE_PERSISTANT_DEVICE "/persistant.txt"
+#define FILE_PERSISTANT_DEVICE "/persistant.bin"
+// Anciens fichiers texte, convertis au premier démarrage
+#define PARAM_TEXT_FILE_NAME "/param.txt"
+#define DLY_PARAM_TEXT_FILE_NAME "/dlyParam.txt"
+#define GLOBAL_SCHEDULED_PARAM_TEXT_FILE_NAME "/globalScheduled.txt"
+#define PERSISTANT_TEXT_FILE_NAME "/persistant.txt"
 // Fichier date
 #define FILE_DATE "/date.txt"
+// Compteurs d'écritures flash (flash_stats.h)
+#define FLASH_STATS_FILE_NAME "/flash_stats.bin"
+// Point d'accès WiFi de la dernière connexion (wifi_cache.h)
+#define WIFI_CACHE_FILE_NAME "/wifi.bin"
 
 
-// Contenu du fichier DLY_PARAM_FILE_NAME (valeurs par défaut)
-//  Temporisations monostables par défaut en secondes
+// Contenu du fichier DLY_PARAM_FILE_NAME
+//  Temporisations monostables en secondes
 //  et paramètres heure été/hivers, enregistrement logs,
 //  mise en route supresseur, sécurité supresseur
-//  (valeurs par défaut)  
-// -----------------------------------------------
-// Durée arrosage 30mn (1800s)
-// Durée commande EV Est 10mn (600s)
-// Durée remplissage réservoir 2mn30 (150s)
-// Durée maximale mise sous pression supresseur 65s
-// Heure d'hivers 1, été 2
-// Autorisation logs 1 sinon 0
-// Autorisation mise en route supresseur 1 sinon 0
-// Secutité supresseur 1 sinon 0
-// -----------------------------------------------
-#define DEFAUT_DELAY_PARAM "1800:600:150:69:1:0:1:1"
-
-// Position des paramètres dans DEFAUT_DELAY_PARAM
+//  (bornes et valeurs par défaut : param_schema.h)
+
+// Position des paramètres dans DLY_PARAM_FILE_NAME
 #define TIME_WATERING         0
 #define EAST_VALVE_ON_TIME    1
 #define TIME_TANK_FILLING     2
@@ -337,37 +401,24 @@ const int MAX_PAS_PERIODE_DEBIT = (PERIODE_DEBIT / PAS_PERIODE_DEBIT);
 #define SUMMER_TIME_OFFSET 2
 #define WINTER_TIME_OFFSET 1
 
-// Contenu du fichier GLOBAL_SCHEDULED_PARAM_FILE_NAME (par défaut)
-// Programmation activée par défaut
-// #define DEFAUT_GLOBAL_SCHEDULED_PARAM "1:1:1:1:1:1"
+// Contenu du fichier GLOBAL_SCHEDULED_PARAM_FILE_NAME
+// Programmation activée par défaut (param_schema.h)
 // Indice des dispositifs associés aux paramètres
 #define POWER_COOK 0
 #define IRRIGATION 1
 #define VANNE_EST  2
 #define PAC        3
 #define VMC        4
+// HMax et MMax de la plage 0 de IRRIGATION : période et compteur de jours du
+// circuit 2 (deux chiffres au plus dans la chaine des paramètres)
+#define MAX_DAYS_CIRCUIT2 99
 #define MAX_ITEMS_GLOBAL_SCHEDULED_PARAM 5
 
 
-#define POWER_COOK_VALUE "1:"
-#define IRRIGATION_VALUE "1:"
-#define VANNE_EST_VALUE "1:"
-// PAC_VALUE 1 : Pac arretée
-#define PAC_VALUE "1:"
-#define VMC_VALUE "1"
-
 #define DEFAULT_DATE "04/07/2025 08:04:16"
 
-#define DEFAUT_GLOBAL_SCHEDULED_PARAM \
-          POWER_COOK_VALUE\
-          IRRIGATION_VALUE\
-          VANNE_EST_VALUE\
-          PAC_VALUE\
-          VMC_VALUE
-
-// Contenu du fichier FILE_PERSISTANT_DEVICE (par défaut)
-// Utilise les mêmes indices que DEFAUT_GLOBAL_SCHEDULED_PARAM 
-#define PERSISTANT "0:0:0:0:0"
+// Contenu du fichier FILE_PERSISTANT_DEVICE (tout à 0 par défaut)
+// Utilise les mêmes indices que GLOBAL_SCHEDULED_PARAM_FILE_NAME
 #define N_PERSISTANT_PARAM MAX_ITEMS_GLOBAL_SCHEDULED_PARAM
 
 // Paramétrage des éléments persistants après reboot
@@ -418,6 +469,7 @@ const char *PARAM = "0:00:00:00:00:0:00:00:00:00:0:00:00:00:00:0:00:00:00:00" \
   VMC        :  tout les champs sont utilisés (toutes les plages utilisées)
 
   La programmation des actions est faite toute les minutes dans schedule()
+  à partir de la table précompilée (schedule.h) reconstruite à chaque modification de param
 
   Pour ajouter un dispositif:
   - ajouter une ligne dans PARAM
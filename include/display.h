@@ -32,6 +32,21 @@ extern void printMqttDebugValue(const char* value);
 extern TACHE_T tache_t_backLight;
 extern TACHE_T tache_t_defaultDisplay;
 
+// Exclusion mutuelle (récursive) des accès à l'afficheur (I2C) :
+// loop(), tâche de scrutation, temporisateurs
+void lcdLock();
+void lcdUnlock();
+
+/**
+ * @brief Verrou de portée de l'afficheur
+ *        Ordre des verrous : CtrlGuard puis LcdGuard, jamais l'inverse.
+ */
+class LcdGuard {
+public:
+  LcdGuard() { lcdLock(); }
+  ~LcdGuard() { lcdUnlock(); }
+};
+
 void lcdClear();
 void displayPrint1(const char* output, const char* input, const char* msg);
 void lcdPrintString(const char* text, int l, int c, boolean clearLine);
@@ -7,13 +7,54 @@
 #include <LittleFS.h>
 #define LittleFS_ LittleFS
 
+// Version du format des enregistrements binaires (writeRecord/readRecord)
+#define RECORD_VERSION 1
+// Copie temporaire d'un enregistrement en cours d'écriture
+#define RECORD_TEMP_SUFFIX ".tmp"
+
+/**
+ * @brief En-tête d'un enregistrement binaire, suivi de size octets de données
+ */
+struct RecordHeader {
+  uint16_t magic;    ///< RECORD_MAGIC
+  uint8_t  version;  ///< RECORD_VERSION
+  uint8_t  format;   ///< Type des données (défini par l'appelant)
+  uint16_t size;     ///< Taille des données
+  uint16_t seq;      ///< Numéro d'écriture (0 : enregistrements antérieurs)
+  uint32_t crc;      ///< CRC32 des données
+};
+
+/**
+ * @brief Fichier LittleFS
+ *
+ * Le système de fichiers est monté une seule fois (mount()). La taille du
+ * fichier est mémorisée et tenue à jour par les écritures : fileSize() ne
+ * relit le système de fichiers qu'au premier appel.
+ *
+ * Les ajouts (writeFile(..., "a")) utilisent un descripteur conservé ouvert :
+ * les données restent dans le cache LittleFS jusqu'à sync(), syncAll() ou
+ * une autre opération sur le fichier (lecture, réécriture, suppression).
+ *
+ * Les enregistrements binaires sont écrits dans une copie temporaire puis
+ * renommés (remplacement atomique) : une coupure d'alimentation laisse
+ * l'ancien ou le nouvel enregistrement complet, jamais un fichier tronqué.
+ */
 class FileLittleFS {
   char path[32];
   File file;
+  File appendFile;            ///< Descripteur d'ajout conservé ouvert
+  long size;                  ///< Taille du fichier, -1 inconnue
+  uint16_t seq;               ///< Numéro du dernier enregistrement lu ou écrit
+  boolean seqKnown;           ///< seq repris du fichier (readRecord ou première écriture)
+  boolean fromTemp;           ///< Dernier enregistrement lu dans la copie temporaire
+  FileLittleFS* nextAppend;   ///< Liste des fichiers ayant un descripteur d'ajout
+  static FileLittleFS* appendFiles;
+  void closeAppend();
   public:
     FileLittleFS(const char *name);
+    ~FileLittleFS();
+    static boolean mount();
     bool open(const char *mode);
-    //~FileLittleFS() {free(path); }
     // void    listDir();
     static boolean exist(const char* name);
     boolean exist();
@@ -23,7 +64,15 @@ class FileLittleFS {
     void    writeFile(const char * message);
     boolean writeFile(const char *message, const char *mode);
     boolean writeFile(String message, const char *mode);
+    boolean append(const void* data, size_t size);
+    int     read(size_t offset, void* data, size_t size);
+    boolean writeRecord(uint8_t format, const void* data, size_t size);
+    int     readRecord(uint8_t format, void* data, size_t size);
+    boolean recovered() { return fromTemp; }
+    static  uint32_t crc32(const void* data, size_t size);
     void    close();
+    void    sync();
+    static  void syncAll();
     static  void rmDir(const char *dirName);
     static  void rmFile(const char *fileName);
     static  void mkDir(const char* dirName);
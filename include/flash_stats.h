@@ -0,0 +1,106 @@
+/**
+ * @file flash_stats.h
+ * @brief Comptage des écritures en mémoire flash (LittleFS) et budget d'écriture.
+ *
+ * Chaque écriture de FileLittleFS (writeFile, writeRecord) et chaque
+ * suppression de fichier est comptée par fichier (nombre, octets). Le débit
+ * glissant sur la dernière heure est calculé sur FLASH_RATE_BUCKETS créneaux.
+ *
+ * Les compteurs sont conservés en mémoire RTC lors d'un redémarrage logiciel
+ * et enregistrés toutes les heures dans FLASH_STATS_FILE_NAME (mise hors
+ * tension). Après une mise sous tension le débit glissant repart de zéro.
+ *
+ * Le budget d'écriture est global : lorsque les écritures de la dernière heure,
+ * tous fichiers confondus, l'atteignent, les écrivains non critiques (logs)
+ * sont suspendus ; les paramètres sont toujours enregistrés.
+ */
+#ifndef FLASH_STATS_H
+#define FLASH_STATS_H
+#include <Arduino.h>
+#include "const.h"
+
+// Nombre de fichiers suivis (les suivants sont cumulés dans le dernier)
+#define MAX_FLASH_FILES 10
+// Taille mémorisée des noms de fichier
+#define FLASH_PATH_SIZE 20
+// Débit glissant : 12 créneaux de 5 mn
+#define FLASH_RATE_BUCKETS 12
+#define FLASH_BUCKET_MS (5 * 60 * 1000UL)
+
+/**
+ * @brief Compteurs d'un fichier depuis la mise en service
+ */
+struct FlashFileStats {
+  char path[FLASH_PATH_SIZE];
+  uint32_t writes;   ///< Ecritures (ouverture en écriture ou ajout)
+  uint32_t bytes;    ///< Octets écrits
+  uint32_t removes;  ///< Suppressions (rotation des logs)
+};
+
+/**
+ * @brief Compteurs de tous les fichiers et débit glissant
+ */
+struct FlashStats {
+  FlashFileStats files[MAX_FLASH_FILES];
+  uint32_t nFiles;
+  uint32_t writeBudget;                  ///< Ecritures par heure (tous fichiers) au-delà desquelles les logs sont suspendus
+  uint32_t throttled;                    ///< Ecritures de logs supprimées
+  uint32_t bucket;                       ///< Numéro du créneau courant
+  uint16_t buckets[FLASH_RATE_BUCKETS];  ///< Ecritures par créneau
+};
+
+/**
+ * @brief Reprend les compteurs : mémoire RTC, sinon FLASH_STATS_FILE_NAME
+ *        (début de setup, avant toute écriture)
+ */
+void flashStatsInit();
+
+/**
+ * @brief Enregistre les compteurs dans FLASH_STATS_FILE_NAME
+ */
+void flashStatsSave();
+
+/**
+ * @brief Compte une écriture
+ * @param path fichier
+ * @param bytes octets écrits
+ */
+void flashAccountWrite(const char* path, size_t bytes);
+
+/**
+ * @brief Compte la suppression d'un fichier
+ */
+void flashAccountRemove(const char* path);
+
+/**
+ * @brief Ecritures de la dernière heure (débit glissant)
+ */
+uint32_t flashWritesLastHour();
+
+/**
+ * @brief Indique si un écrivain non critique doit renoncer à écrire
+ *        Compte l'écriture supprimée si le budget est dépassé.
+ * @return true si les écritures de la dernière heure, tous fichiers
+ *         confondus, atteignent le budget
+ */
+boolean flashThrottle();
+
+/**
+ * @brief Ecritures supprimées par flashThrottle() depuis l'appel précédent
+ *        (remise à zéro, sous flashMux : tâche de scrutation et loop())
+ * @return uint32_t nombre d'écritures de logs supprimées
+ */
+uint32_t flashThrottledTake();
+
+/**
+ * @brief Modifie le budget d'écriture global
+ * @param budget écritures par heure, tous fichiers (FLASH_MIN_BUDGET minimum)
+ */
+void flashSetBudget(uint32_t budget);
+
+/**
+ * @brief Copie des compteurs
+ */
+void flashStatsTake(FlashStats* stats);
+
+#endif
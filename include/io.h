@@ -17,15 +17,43 @@
 #ifndef __IO_H
 #define __IO_H
 #include <ArduinoOTA.h>
+#include <atomic>
 #include "const.h"
 
 extern boolean irSendPacOff;
-extern boolean ioChange;
+// Positionné par on()/off() depuis loop ou les callbacks des temporisateurs
+extern std::atomic<bool> ioChange;
+/**
+ * @brief Statistiques d'acquisition des E/S
+ *        Un "scan" correspond à un appel de sampleInputs()
+ */
+struct IoStats {
+  unsigned long scans;          ///< Nombre d'échantillonnages des entrées
+  unsigned long inputTimestamp; ///< millis() du dernier échantillonnage
+  unsigned lastScanToggles;     ///< Commutations GPIO durant le dernier cycle
+  unsigned maxScanToggles;      ///< Maximum de commutations GPIO sur un cycle
+};
+
+void initShiftRegisters();
 unsigned readByteInput();
+unsigned sampleInputs();
+const IoStats* ioStats();
 boolean readBitsInput(unsigned mask);
 
 void writeBitOutput(unsigned num, int value);
 void clear74HC595();
+// Transaction d'écriture des relais : un seul verrouillage pour plusieurs on()/off()
+void ioBegin();
+void ioCommit();
+// Ecriture des relais modifiés depuis le cycle précédent (cycle de scrutation uniquement)
+void ioFlush();
+
+#ifdef IO_BACKEND_MOCK
+// Registres simulés : positionnement des contacts fermés et lecture des relais
+void ioMockSetInputs(unsigned closedMask);
+unsigned ioMockOutputs();
+unsigned long ioMockLatchCount();
+#endif
 
 /**
  * @brief Lit un port E/S
@@ -96,13 +124,11 @@ inline void off(int adr) {
  * @param adr 
  */
 inline void on(int adr) {
-  // time_exec_start();
 #ifdef ES32A08  
   digital_write(adr, 1);
 #else  
   digital_write(adr, 0);
 #endif
-  // time_exec_stop();
   ioChange = true;
 }
 /**
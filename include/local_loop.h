@@ -5,10 +5,13 @@
 #include <ArduinoOTA.h>
 #include <PubSubClient.h>
 #include "files.h"
+#include "param_store.h"
 #include "display.h"
 #include "mtr86.h"
 #include "const.h"
 #include "io.h"
+#include "logs.h"
+#include "mqtt_queue.h"
 
 extern boolean isEdge(int nButton);
 extern boolean isWatering;
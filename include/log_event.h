@@ -0,0 +1,63 @@
+/**
+ * @file log_event.h
+ * @brief Evénements binaires du journal.
+ *
+ * Un événement est enregistré sous forme binaire (LOG_TYPE_EVENT) : date,
+ * code, dispositif et valeur, suivis éventuellement d'un texte (EV_TEXT).
+ * L'écriture d'un événement ne formate aucune chaine ; le texte lisible
+ * (date et message) n'est produit qu'à la relecture du journal
+ * (formatEvent, TOPIC_LOGS_GET).
+ */
+#ifndef LOG_EVENT_H
+#define LOG_EVENT_H
+#include <Arduino.h>
+
+// Codes des événements (LogEvent::code)
+#define EV_TEXT              0   // Message texte à la suite de l'événement
+#define EV_PAC_ON            1
+#define EV_PAC_OFF           2
+#define EV_COOK_ON           3
+#define EV_COOK_OFF          4
+#define EV_VMC_ON            5
+#define EV_VMC_OFF           6
+#define EV_WATERING_ON       7
+#define EV_WATERING_OFF      8
+#define EV_TANK_FILLING_ON   9
+#define EV_TANK_FILLING_OFF  10
+#define EV_VANNE_EST_ON      11
+#define EV_VANNE_EST_OFF     12
+#define EV_SUPRESSOR_EN      13
+#define EV_SUPRESSOR_DIS     14
+#define EV_TANK_FILLING_STOP 15  // Arrêt par le surpresseur
+#define EV_WATERING_STOP     16  // Arrêt par le surpresseur
+#define EV_SUPRESSOR_FILLING 17
+#define EV_SUPRESSOR_FILLED  18
+#define EV_SUPRESSOR_FAULT   19
+#define EV_PUMP_FAULT        20
+#define EV_CATCH_UP_ON       21  // device : dispositif, value : minute de l'événement
+#define EV_CATCH_UP_OFF      22
+#define EV_THROTTLED         23  // value : logs non écrits (budget flash)
+#define N_EVENTS             24
+
+/**
+ * @brief Evénement enregistré (8 octets, suivis du texte pour EV_TEXT)
+ */
+struct LogEvent {
+  uint32_t time;    ///< Date locale en secondes
+  uint8_t  code;    ///< EV_*
+  uint8_t  device;  ///< Dispositif (POWER_COOK, IRRIGATION...) si utile
+  uint16_t value;   ///< Valeur associée au code
+};
+
+/**
+ * @brief Texte lisible d'un enregistrement du journal
+ * @param type LOG_TYPE_TEXT ou LOG_TYPE_EVENT
+ * @param data données de l'enregistrement
+ * @param size taille des données
+ * @param buffer texte "JJ/MM/AAAA HH:MM:SS - message"
+ * @param length taille de buffer
+ * @return int longueur du texte
+ */
+int formatEvent(uint8_t type, const uint8_t* data, size_t size, char* buffer, size_t length);
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * @file log_store.h
+ * @brief Journal circulaire en mémoire flash (LittleFS).
+ *
+ * Le journal est réparti sur LOG_SEGMENTS fichiers de LOG_SEGMENT_SIZE octets
+ * au plus. Chaque enregistrement a un en-tête (numéro de séquence, taille,
+ * type, contrôle) suivi des données. L'ajout se fait en fin du segment courant
+ * (descripteur d'ajout conservé ouvert) ; quand le segment est plein, le
+ * segment suivant, le plus ancien, est effacé et devient le segment courant.
+ * Les LOG_SEGMENTS - 1 derniers segments pleins restent donc toujours
+ * disponibles, au lieu de perdre tout l'historique à la suppression du fichier.
+ *
+ * Les numéros de séquence croissent sans interruption (y compris après clear())
+ * et permettent de relire le journal à partir du dernier numéro reçu.
+ *
+ * Au démarrage, les segments sont parcourus pour retrouver le segment courant
+ * et le prochain numéro ; un enregistrement incomplet (coupure d'alimentation
+ * pendant l'écriture) termine le segment, l'écriture reprend au segment suivant.
+ */
+#ifndef LOG_STORE_H
+#define LOG_STORE_H
+#include <Arduino.h>
+#include "const.h"
+#include "files.h"
+
+// Taille maximale des données d'un enregistrement
+#define LOG_MAX_RECORD 255
+// Type des données d'un enregistrement (LogHeader::type)
+#define LOG_TYPE_TEXT  0  // Ligne de texte datée (anciens logs)
+#define LOG_TYPE_EVENT 1  // Evénement binaire (log_event.h)
+
+/**
+ * @brief En-tête d'un enregistrement, suivi de size octets de données
+ *        check : 16 bits de poids faible du CRC32 de la suite de l'en-tête
+ *        et des données.
+ */
+struct LogHeader {
+  uint16_t check;
+  uint8_t  size;
+  uint8_t  type;
+  uint32_t seq;
+};
+
+/**
+ * @brief Traitement d'un enregistrement relu
+ */
+typedef void (*LogCallback)(uint32_t seq, uint8_t type, const uint8_t* data, size_t size, void* context);
+
+/**
+ * @class LogStore
+ * @brief Journal circulaire segmenté
+ */
+class LogStore {
+  FileLittleFS* segments[LOG_SEGMENTS];
+  uint32_t first[LOG_SEGMENTS];  ///< Premier numéro de chaque segment, 0 si vide
+  size_t used[LOG_SEGMENTS];     ///< Octets valides de chaque segment
+  int head;                      ///< Segment courant
+  uint32_t next;                 ///< Prochain numéro
+  SemaphoreHandle_t mutex;
+  int scan(int segment, uint8_t* buffer, uint32_t* last);
+  void nextSegment();
+  void lock() { if (mutex) xSemaphoreTake(mutex, portMAX_DELAY); }
+  void unlock() { if (mutex) xSemaphoreGive(mutex); }
+
+public:
+  LogStore();
+
+  /**
+   * @brief Parcourt les segments existants
+   * @param clear efface le journal
+   */
+  void begin(boolean clear);
+
+  /**
+   * @brief Ajoute un enregistrement
+   * @param data données (tronquées à LOG_MAX_RECORD octets)
+   * @param size taille des données
+   * @param type type des données
+   * @return uint32_t numéro de l'enregistrement, 0 en cas d'erreur
+   */
+  uint32_t append(const void* data, size_t size, uint8_t type = LOG_TYPE_TEXT);
+
+  /**
+   * @brief Efface le journal, la numérotation se poursuit
+   */
+  void clear();
+
+  /**
+   * @brief Relit les enregistrements à partir d'un numéro
+   *        Les segments sont copiés un à un ; callback est appelé hors verrou.
+   * @param from premier numéro souhaité (0 : le plus ancien)
+   * @param callback traitement de chaque enregistrement
+   * @param context paramètre de callback
+   * @return uint32_t numéro suivant le dernier enregistrement relu
+   */
+  uint32_t read(uint32_t from, LogCallback callback, void* context);
+
+  uint32_t nextSeq() { return next; }
+};
+
+#endif
@@ -3,5 +3,9 @@
 #include <Arduino.h>
 #include "files.h"
 #include "const.h"
+#include "log_event.h"
 extern void writeLogs(const char* log);
+extern void logsWrite(const char* log);
+extern void writeEvent(uint8_t code, uint8_t device = 0, uint16_t value = 0);
+extern void eventWrite(uint8_t code, uint8_t device, uint16_t value, const char* text);
 #endif
\ No newline at end of file
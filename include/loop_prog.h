@@ -130,20 +130,21 @@
 #include "rotary_encoder.h"
 #include "param.h"
 #include "simple_param.h"
+#include "param_store.h"
 #include "display.h"
 #include "const.h"
 #include "io.h"
 
-// Butées temporelles 
+// Butées temporelles (bornes du schéma des paramètres, param_schema.h)
 // Temps en secondes
-#define MaxTimeOutWaterring 60*60  
-#define MinTimeOutWaterring 10*60
-#define MaxTimeTankFilling  200
-#define MinTimeTankFilling  100
-#define MaxTimeOutWaterringEV_Est 20*60
-#define MinTimeOutWaterringEV_Est  5*60
-#define MaxTimeOutSupressor  100
-#define MinTimeOutSupressor  50
+#define MaxTimeOutWaterring dlyParamFields[TIME_WATERING].max
+#define MinTimeOutWaterring dlyParamFields[TIME_WATERING].min
+#define MaxTimeTankFilling  dlyParamFields[TIME_TANK_FILLING].max
+#define MinTimeTankFilling  dlyParamFields[TIME_TANK_FILLING].min
+#define MaxTimeOutWaterringEV_Est dlyParamFields[EAST_VALVE_ON_TIME].max
+#define MinTimeOutWaterringEV_Est dlyParamFields[EAST_VALVE_ON_TIME].min
+#define MaxTimeOutSupressor dlyParamFields[TIME_SUPRESSOR].max
+#define MinTimeOutSupressor dlyParamFields[TIME_SUPRESSOR].min
 
 extern boolean isWatering;
 // Un entier suffit pour contenir les valeurs
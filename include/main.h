@@ -20,7 +20,7 @@
 #ifndef MAIN_H
 #define MAIN_H
 
-const char* version = "26.07.26";
+const char* version = "26.10.17";
 
 // Definitions for print modes
 #define WEB_PRINT false
@@ -47,7 +47,18 @@ const char* version = "26.07.26";
 // #include "display.h"
 #include "mtr86.h"
 #include "param.h"
+#include "schedule.h"
+#include "scan.h"
+#include "profile.h"
+#include "flash_stats.h"
+#include "log_store.h"
+#include "log_event.h"
+#include "topic_table.h"
+#include "mqtt_queue.h"
+#include "net_link.h"
+#include "wifi_cache.h"
 #include "simple_param.h"
+#include "param_store.h"
 #include "rotary_encoder.h"
 #include "loop_prog.h"
 #include "local_loop.h"
@@ -67,10 +78,6 @@ const char *hostname = HOSTNAME;
 WiFiClient wifiClient;
 #ifdef ALEXA
 
-#endif
-#ifdef TIME_SIMULATOR
-static int h;
-static int m;
 #endif
 
 // Parameter string for 24-hour scheduled cycles
@@ -170,7 +177,7 @@ boolean supressorFillingMonoStart;
 boolean supressorFillingSecurity;
 boolean monoSurpressorSecurityStarted;
 boolean wifiConnected;
-boolean ioChange;
+std::atomic<bool> ioChange(false);
 
 unsigned appConnected;
 unsigned cmdVanneEst = 1;
@@ -194,7 +201,7 @@ void (*funcToCall2)();
 
 // Pointers to dynamically allocated classes
 static FileLittleFS* fileParam;
-static FileLittleFS *fileLogs;
+static LogStore *logStore;
        FileLittleFS *fileDlyParam;
        FileLittleFS* fileGlobalScheduledParam;
        FileLittleFS* filePersistantParam;
@@ -216,6 +223,7 @@ OneButton button(ROTARY_ENCODER_BUTTON_PIN, true);
 // Pointers to dynamically allocated objects
 static ESP32Time* rtc;
 Param* cParam;
+Schedule* cSchedule;
 SimpleParam* cDlyParam;
 SimpleParam* cGlobalScheduledParam;
 SimpleParam* cPersistantParam;
@@ -224,6 +232,9 @@ fauxmoESP fauxmo;
 #endif
 // Pre-declared function prototypes
 void PubSubCallback(char* topic, byte* payload, unsigned int length);
+void subscribeTopics();
+void publishStatus();
+void publishNextEvent();
 // void writeLogs(const char * msg);
 void deleteLogs();
 const char *getDate();
@@ -285,35 +296,14 @@ void monoDefaultDisplay(TimerHandle_t xTimer);
 void monoOffCircuit2(TimerHandle_t xTimer);
 void monoDebit(TimerHandle_t xTimer);
 void monoSurpressorSecurity(TimerHandle_t xTimer);
-#ifdef EXEC_TIME_MEASURE
-unsigned long Temps_stop_us;
-unsigned long Temps_start_us;
-unsigned long Duree_us;
-
-/**
- * @brief Stop execution time measurement and print the duration.
- */
-inline void time_exec_stop() {
-  Temps_stop_us = micros();
-  Duree_us = Temps_stop_us - Temps_start_us;
-  Serial.print(Duree_us);
-  Serial.print("    \rus:");
-}
-
-/**
- * @brief Start execution time measurement.
- */
-inline void time_exec_start() {
-  Temps_start_us = micros();
-}
-#endif
-
 // Inline functions
 /**
  * @brief Initialize OTA updates.
  */
 inline void initOTA() {
   ArduinoOTA.setHostname(HOSTNAME);
+  // Redémarrage en fin de mise à jour : paramètres en attente enregistrés
+  ArduinoOTA.onEnd([]() { persistFlush(); });
   ArduinoOTA.begin();
 }
 
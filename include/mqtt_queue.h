@@ -0,0 +1,61 @@
+/**
+ * @file mqtt_queue.h
+ * @brief File d'attente des publications MQTT.
+ *
+ * mqttPublish() ne fait que copier le message dans une file bornée et rend la
+ * main immédiatement : elle peut être appelée depuis loop(), la tâche de
+ * scrutation, les callbacks Alexa et les callbacks des temporisateurs. La
+ * file est vidée par mqttQueueDrain(), appelée par loop() après
+ * mqttClient.loop(), quand le client est connecté.
+ *
+ * Les topics d'état (statusTopics dans mqtt_queue.cpp : état VMC, PAC,
+ * cuisine, gpio...) ne gardent que leur dernière valeur : une nouvelle
+ * valeur remplace celle en attente, à sa place dans la file. Les autres
+ * topics (commandes IR, carte VMC...) sont publiés dans l'ordre.
+ *
+ * Les réponses volumineuses aux requêtes (paramètres, logs, statistiques),
+ * émises depuis le callback MQTT, restent publiées directement.
+ */
+#ifndef MQTT_QUEUE_H
+#define MQTT_QUEUE_H
+#include <Arduino.h>
+#include <PubSubClient.h>
+#include "const.h"
+
+// Messages en attente
+#define MQTT_QUEUE_SIZE 24
+// Taille maximale du contenu d'un message (y compris '\0')
+#define MQTT_QUEUE_PAYLOAD 32
+
+/**
+ * @brief Compteurs de la file depuis le démarrage
+ */
+struct MqttQueueStats {
+  uint32_t queued;     ///< Messages ajoutés à la file
+  uint32_t coalesced;  ///< Valeurs d'état remplacées avant publication
+  uint32_t dropped;    ///< Messages perdus (file pleine, contenu trop long)
+  uint32_t published;  ///< Messages publiés
+  uint32_t maxDepth;   ///< Occupation maximale de la file
+  uint32_t pending;    ///< Messages en attente
+};
+
+/**
+ * @brief Ajoute un message à la file
+ * @param topic chaine constante (TOPIC_*), non copiée
+ * @param payload contenu, copié (MQTT_QUEUE_PAYLOAD - 1 caractères au plus)
+ * @return true si le message est en attente de publication
+ */
+boolean mqttPublish(const char* topic, const char* payload);
+
+/**
+ * @brief Publie les messages en attente (loop, client connecté)
+ *        Un échec de publication laisse le message en tête de file.
+ */
+void mqttQueueDrain(PubSubClient& client);
+
+/**
+ * @brief Copie des compteurs
+ */
+void mqttQueueStatsTake(MqttQueueStats* stats);
+
+#endif
@@ -0,0 +1,87 @@
+/**
+ * @file net_link.h
+ * @brief Reconnexion WiFi / courtier MQTT sans blocage de loop().
+ *
+ * Après la connexion initiale (setup), la liaison est surveillée par un
+ * automate appelé à chaque passage de loop() :
+ *
+ *   NET_UP -> NET_WIFI_DOWN -> NET_WIFI_WAIT -> NET_BROKER -> NET_SUBSCRIBE
+ *          -> NET_RESYNC -> NET_UP
+ *
+ * - NET_WIFI_DOWN : wifiCacheBegin() (non bloquant) à l'échéance de la tentative
+ * - NET_WIFI_WAIT : attente de WL_CONNECTED, au plus WIFI_DIRECT_TIMEOUT vers le
+ *                   point d'accès mémorisé (recherche complète aussitôt après
+ *                   un échec), NET_WIFI_TIMEOUT sinon
+ * - NET_BROKER    : une seule tentative de connexion au courtier par passage,
+ *                   bornée par NET_SOCKET_TIMEOUT
+ * - NET_SUBSCRIBE : abonnements (onSubscribe)
+ * - NET_RESYNC    : republication de l'état courant (onResync)
+ *
+ * Après un échec, la tentative suivante est retardée d'un délai doublé à
+ * chaque échec (NET_BACKOFF_MIN à NET_BACKOFF_MAX), tiré au hasard dans sa
+ * seconde moitié pour ne pas synchroniser les clients après une coupure du
+ * courtier. Chaque étape rend la main : la scrutation, les commandes locales
+ * et les temporisateurs continuent pendant la coupure.
+ */
+#ifndef NET_LINK_H
+#define NET_LINK_H
+#include <Arduino.h>
+#include <WiFi.h>
+#include <PubSubClient.h>
+#include "const.h"
+#include "wifi_cache.h"
+
+enum NetState {
+  NET_UP,
+  NET_WIFI_DOWN,
+  NET_WIFI_WAIT,
+  NET_BROKER,
+  NET_SUBSCRIBE,
+  NET_RESYNC,
+};
+
+/**
+ * @brief Paramètres de connexion et traitements de l'application
+ */
+struct NetLinkConfig {
+  const char* ssid;
+  const char* password;
+  const char* mqttUser;
+  const char* mqttPassword;
+  void (*onSubscribe)();  ///< Abonnements après connexion au courtier
+  void (*onResync)();     ///< Republication de l'état
+};
+
+/**
+ * @brief Compteurs depuis le démarrage
+ */
+struct NetLinkStats {
+  uint32_t state;           ///< Etat courant (NetState)
+  uint32_t outages;         ///< Pertes de connexion au courtier
+  uint32_t reconnects;      ///< Reconnexions abouties
+  uint32_t wifiAttempts;    ///< Appels de WiFi.begin()
+  uint32_t brokerAttempts;  ///< Tentatives de connexion au courtier
+  uint32_t lastReconnect;   ///< Durée de la dernière coupure (ms)
+  uint32_t maxReconnect;    ///< Durée maximale d'une coupure (ms)
+};
+
+/**
+ * @brief Démarre la surveillance (fin de setup)
+ * @param client client MQTT configuré (serveur, callback)
+ * @param config paramètres, conservés par référence
+ * @param connected true si la connexion initiale au courtier est établie
+ */
+void netLinkBegin(PubSubClient& client, const NetLinkConfig& config, boolean connected);
+
+/**
+ * @brief Avance l'automate d'une étape (loop, hors exclusion mutuelle)
+ * @return NetState état courant
+ */
+NetState netLinkLoop();
+
+/**
+ * @brief Copie des compteurs
+ */
+void netLinkStatsTake(NetLinkStats* stats);
+
+#endif
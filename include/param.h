@@ -7,6 +7,11 @@
 #include <Arduino.h>
 #include "const.h"
 
+// Nombre de champs d'une plage enable:HMin:MMin:HMax:MMax
+#define N_FIELDS 5
+// Taille de la représentation binaire (un octet par champ)
+#define PARAM_RECORD_SIZE (N_PARAM * N_FIELDS)
+
 class ItemParam {
   public:
   int enable;
@@ -32,6 +37,23 @@ public:
 class Param {
   ItemParam _param[N_PARAM]; ///< Array of parameters.
   char _sparam[(TAILLE_PLAGE * N_PLAGES * N_DEVICES) + 2]; ///< String containing the parameters.
+  unsigned _version; ///< Incremented on every change of the parameters.
+  uint32_t _dirty; ///< Ranges whose slot in _sparam is out of date (bit i = range i).
+  char _error[64]; ///< Description of the last parse error, empty if none.
+
+  /**
+   * @brief Single pass parser, no allocation: fills param only if the whole
+   *        string is valid.
+   * @param str String containing the parameters.
+   * @param param Array of N_PARAM items to fill.
+   * @return true if the string is valid, false otherwise (see error()).
+   */
+  boolean parse(const char* str, ItemParam* param);
+
+  /**
+   * @brief Renders range i into its fixed-width slot of _sparam.
+   */
+  void render(int i);
 
 public:
   /**
@@ -50,6 +72,7 @@ public:
 
   /**
    * @brief Set a parameter at a specific index and time.
+   *        Only this range is marked for rendering; nothing is done if it is unchanged.
    * @param nParam The index of the parameter.
    * @param timeSet The time associated with the parameter.
    * @param ItemParam The parameter to set.
@@ -58,6 +81,7 @@ public:
 
   /**
    * @brief Get the string representation of the parameters.
+   *        Ranges modified since the last call are rendered into their slot.
    * @return A pointer to the string containing the parameters.
    */
   char* getStr();
@@ -66,21 +90,53 @@ public:
 
   /**
    * @brief Set the parameters from a string.
+   *        The current parameters are kept if the string is invalid.
    * @param str A string containing the parameters.
+   * @return true if the string is valid, false otherwise (see error()).
+   */
+  boolean setStr(const char* str);
+
+  /**
+   * @brief Set the parameters from their string representation.
+   * @return true if the string is valid, false otherwise (see error()).
    */
-  void setStr(const char* str);
+  boolean setParam();
 
   /**
-   * @brief Set the parameters.
+   * @brief Binary representation of the parameters (one byte per field).
+   * @param data Output buffer of PARAM_RECORD_SIZE bytes.
    */
-  void setParam();
+  void pack(uint8_t* data);
 
   /**
-   * @brief Update the string representation of the parameters.
-   * @param param A string containing the new parameters.
+   * @brief Set the parameters from their binary representation.
+   *        The current parameters are kept if the data is invalid.
+   * @param data Buffer written by pack().
+   * @param size Size of the buffer.
+   * @return true if the data is valid, false otherwise (see error()).
+   */
+  boolean unpack(const uint8_t* data, size_t size);
+
+  /**
+   * @brief Description of the last parse error.
+   * @return NULL if the last parse succeeded.
+   */
+  const char* error() { return _error[0] ? _error : NULL; }
+
+  /**
+   * @brief Copy the string representation of the parameters.
+   *        getStr() is kept up to date, calling this on getStr() is not needed.
+   * @param param Output buffer of at least TAILLE_PLAGE * N_PARAM bytes.
    */
   void updateStringParam(char* param);
 
+  /**
+   * @brief Version of the parameters, incremented on every change.
+   *        Used by Schedule to recompile its event table.
+   * @return The current version.
+   */
+  unsigned version() { return _version; }
+
   /**
    * @brief Print the parameters.
    */
@@ -0,0 +1,129 @@
+/**
+ * @file param_schema.h
+ * @brief Schéma des paramètres simples : temporisations, autorisations de
+ *        programmation et états persistants.
+ *
+ * Chaque paramètre est décrit à la compilation (nom, type, bornes, valeur par
+ * défaut, classe de persistance). SimpleParam en déduit :
+ * - son stockage (tableau de taille fixe, sans allocation),
+ * - la lecture de la chaine MQTT "v0:v1:..." (valeurs hors bornes rejetées),
+ * - la chaine publiée et l'enregistrement binaire (param_store.h),
+ * - le schéma publié sur homecontrol/param_schema.
+ * Les butées des menus de réglage (loop_prog.h) sont lues dans ce schéma :
+ * valeurs mémorisées et réglages locaux ne peuvent plus diverger.
+ *
+ * L'ordre des champs est celui des indices de const.h (TIME_WATERING,
+ * POWER_COOK...), vérifié par static_assert.
+ */
+#ifndef PARAM_SCHEMA_H
+#define PARAM_SCHEMA_H
+#include <Arduino.h>
+#include "const.h"
+
+// Nombre maximum de champs d'un schéma (stockage de SimpleParam)
+#define MAX_SCHEMA_FIELDS 16
+
+enum ParamType : uint8_t {
+  PARAM_INT,      ///< Entier
+  PARAM_BOOL,     ///< 0 ou 1
+  PARAM_SECONDS   ///< Durée en secondes
+};
+
+enum ParamPersistence : uint8_t {
+  PERSIST_CONFIG, ///< Réglage utilisateur, modifié rarement
+  PERSIST_STATE   ///< Etat de fonctionnement, modifié à chaque commande
+};
+
+struct ParamField {
+  const char* name;
+  ParamType type;
+  int32_t min;
+  int32_t max;
+  int32_t def;
+  ParamPersistence persistence;
+};
+
+struct ParamSchema {
+  const char* name;          ///< Préfixe des messages d'erreur et du schéma publié
+  const ParamField* fields;
+  uint8_t size;
+};
+
+// Temporisations et réglages (DLY_PARAM_FILE_NAME)
+static constexpr ParamField dlyParamFields[] = {
+  { "time_watering",         PARAM_SECONDS, 10 * 60, 60 * 60, 1800, PERSIST_CONFIG },
+  { "east_valve_on_time",    PARAM_SECONDS,  5 * 60, 20 * 60,  600, PERSIST_CONFIG },
+  { "time_tank_filling",     PARAM_SECONDS,     100,     200,  150, PERSIST_CONFIG },
+  { "time_supressor",        PARAM_SECONDS,      50,     100,   69, PERSIST_CONFIG },
+  { "summer_time",           PARAM_INT, WINTER_TIME_OFFSET, SUMMER_TIME_OFFSET, WINTER_TIME_OFFSET, PERSIST_CONFIG },
+  { "log_status",            PARAM_BOOL,          0,       1,    0, PERSIST_CONFIG },
+  // Désactivé automatiquement par la sécurité surpresseur
+  { "supressor_en",          PARAM_BOOL,          0,       1,    1, PERSIST_STATE },
+  { "supressor_security_en", PARAM_BOOL,          0,       1,    1, PERSIST_CONFIG },
+};
+
+// Autorisation des cycles programmés par dispositif (GLOBAL_SCHEDULED_PARAM_FILE_NAME)
+static constexpr ParamField globalScheduledParamFields[] = {
+  { "power_cook", PARAM_BOOL, 0, 1, 1, PERSIST_CONFIG },
+  { "irrigation", PARAM_BOOL, 0, 1, 1, PERSIST_CONFIG },
+  { "vanne_est",  PARAM_BOOL, 0, 1, 1, PERSIST_CONFIG },
+  { "pac",        PARAM_BOOL, 0, 1, 1, PERSIST_CONFIG },
+  { "vmc",        PARAM_BOOL, 0, 1, 1, PERSIST_CONFIG },
+};
+
+// Etats restaurés après reboot (FILE_PERSISTANT_DEVICE), mêmes indices
+static constexpr ParamField persistantParamFields[] = {
+  { "power_cook", PARAM_BOOL, 0, 1,       0, PERSIST_STATE },
+  { "irrigation", PARAM_BOOL, 0, 1,       0, PERSIST_STATE },
+  { "vanne_est",  PARAM_BOOL, 0, 1,       0, PERSIST_STATE },
+  { "pac",        PARAM_BOOL, 0, 1,       0, PERSIST_STATE },
+  // Dernière commande setVmc() (CMD_VMC_*), rejouée au démarrage
+  { "vmc",        PARAM_INT,  CMD_VMC_OFF, CMD_VMC_TOILET_FAST, CMD_VMC_OFF, PERSIST_STATE },
+};
+
+#define SCHEMA_SIZE(fields) (sizeof(fields) / sizeof(ParamField))
+
+static constexpr ParamSchema dlyParamSchema =
+  { "dly", dlyParamFields, SCHEMA_SIZE(dlyParamFields) };
+static constexpr ParamSchema globalScheduledParamSchema =
+  { "global", globalScheduledParamFields, SCHEMA_SIZE(globalScheduledParamFields) };
+static constexpr ParamSchema persistantParamSchema =
+  { "persistant", persistantParamFields, SCHEMA_SIZE(persistantParamFields) };
+
+// Vérifications à la compilation
+constexpr bool sameName(const char* a, const char* b) {
+  return *a == *b && (*a == '\0' || sameName(a + 1, b + 1));
+}
+constexpr bool validFields(const ParamField* f, unsigned n) {
+  return n == 0 || (f->min <= f->def && f->def <= f->max && validFields(f + 1, n - 1));
+}
+
+static_assert(SCHEMA_SIZE(dlyParamFields) == N_DLY_PARAM, "dlyParamFields : N_DLY_PARAM");
+static_assert(SCHEMA_SIZE(globalScheduledParamFields) == MAX_ITEMS_GLOBAL_SCHEDULED_PARAM,
+              "globalScheduledParamFields : MAX_ITEMS_GLOBAL_SCHEDULED_PARAM");
+static_assert(SCHEMA_SIZE(persistantParamFields) == N_PERSISTANT_PARAM,
+              "persistantParamFields : N_PERSISTANT_PARAM");
+static_assert(N_DLY_PARAM <= MAX_SCHEMA_FIELDS, "MAX_SCHEMA_FIELDS");
+static_assert(validFields(dlyParamFields, N_DLY_PARAM), "dlyParamFields : défaut hors bornes");
+static_assert(validFields(globalScheduledParamFields, MAX_ITEMS_GLOBAL_SCHEDULED_PARAM),
+              "globalScheduledParamFields : défaut hors bornes");
+static_assert(validFields(persistantParamFields, N_PERSISTANT_PARAM),
+              "persistantParamFields : défaut hors bornes");
+static_assert(sameName(dlyParamFields[TIME_WATERING].name, "time_watering") &&
+              sameName(dlyParamFields[EAST_VALVE_ON_TIME].name, "east_valve_on_time") &&
+              sameName(dlyParamFields[TIME_TANK_FILLING].name, "time_tank_filling") &&
+              sameName(dlyParamFields[TIME_SUPRESSOR].name, "time_supressor") &&
+              sameName(dlyParamFields[SUMMER_TIME].name, "summer_time") &&
+              sameName(dlyParamFields[LOG_STATUS].name, "log_status") &&
+              sameName(dlyParamFields[SUPRESSOR_EN].name, "supressor_en") &&
+              sameName(dlyParamFields[SURPRESSOR_SECURIT_EN].name, "supressor_security_en"),
+              "dlyParamFields : ordre des indices de const.h");
+static_assert(sameName(persistantParamFields[POWER_COOK].name, "power_cook") &&
+              sameName(persistantParamFields[IRRIGATION].name, "irrigation") &&
+              sameName(persistantParamFields[VANNE_EST].name, "vanne_est") &&
+              sameName(persistantParamFields[PAC].name, "pac") &&
+              sameName(persistantParamFields[VMC].name, "vmc") &&
+              sameName(globalScheduledParamFields[VMC].name, "vmc"),
+              "persistantParamFields : ordre des indices de const.h");
+
+#endif
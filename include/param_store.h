@@ -0,0 +1,98 @@
+/**
+ * @file param_store.h
+ * @brief Mémorisation binaire des paramètres en mémoire flash.
+ *
+ * Plages horaires (Param), temporisations, autorisations de programmation et
+ * éléments persistants (SimpleParam) sont enregistrés sous forme binaire
+ * (FileLittleFS::writeRecord) : en-tête versionné, numéro d'écriture et CRC32,
+ * remplacement atomique par renommage d'une copie temporaire. Au démarrage,
+ * la copie la plus récente valide est retenue (journalisée si c'est la copie
+ * temporaire) ; un fichier corrompu est remplacé par les valeurs par défaut.
+ *
+ * La représentation texte "1:06:00:08:00:..." n'est plus utilisée que pour
+ * le protocole MQTT. Les anciens fichiers texte sont convertis au premier
+ * démarrage puis supprimés.
+ *
+ * Les paramètres simples sont enregistrés en différé (persistParam) : les
+ * modifications d'une fenêtre de PERSIST_WINDOW ms (rafale de commandes VMC,
+ * actions programmées de la même minute) donnent une seule écriture, faite par
+ * la tâche PERSIST_TASK hors des callbacks MQTT. persistFlush() doit être
+ * appelé avant ESP.restart().
+ */
+#ifndef PARAM_STORE_H
+#define PARAM_STORE_H
+#include <Arduino.h>
+#include "files.h"
+#include "param.h"
+#include "simple_param.h"
+
+// Format des enregistrements (RecordHeader::format)
+#define RECORD_FORMAT_ITEMS 1  // Plages Param : un octet par champ
+#define RECORD_FORMAT_INTS  2  // SimpleParam : entiers 32 bits
+
+/**
+ * @brief Enregistre les plages horaires
+ * @param file fichier retourné par openParam()
+ * @param param plages horaires
+ * @return true si l'écriture a réussi
+ */
+boolean saveParam(FileLittleFS* file, Param* param);
+
+/**
+ * @brief Enregistre des paramètres simples (temporisations, autorisations, persistance)
+ * @param file fichier retourné par openParam()
+ * @param param paramètres
+ * @return true si l'écriture a réussi
+ */
+boolean saveParam(FileLittleFS* file, SimpleParam* param);
+
+/**
+ * @brief Charge les plages horaires
+ *        Ordre : enregistrement binaire, ancien fichier texte (migration),
+ *        valeurs courantes de param (valeurs par défaut).
+ * @param name fichier binaire
+ * @param textName ancien fichier texte
+ * @param param plages horaires initialisées avec les valeurs par défaut
+ * @param force ignore les fichiers, enregistre les valeurs par défaut
+ * @return FileLittleFS* fichier binaire
+ */
+FileLittleFS* openParam(const char* name, const char* textName, Param* param, boolean force);
+
+/**
+ * @brief Charge des paramètres simples (voir openParam(Param))
+ *        Un enregistrement plus court (paramètre ajouté) conserve les
+ *        valeurs par défaut des derniers paramètres. Les valeurs sont
+ *        ramenées dans les bornes du schéma.
+ */
+FileLittleFS* openParam(const char* name, const char* textName, SimpleParam* param, boolean force);
+
+/**
+ * @brief Demande l'enregistrement différé de paramètres simples
+ *        L'écriture a lieu au plus tard PERSIST_WINDOW ms après la première
+ *        demande non enregistrée, les demandes suivantes sont regroupées.
+ *        Avant persistInit() l'enregistrement est immédiat.
+ * @param file fichier retourné par openParam()
+ * @param param paramètres
+ */
+void persistParam(FileLittleFS* file, SimpleParam* param);
+
+/**
+ * @brief Enregistre les paramètres dont la fenêtre de regroupement est écoulée
+ *        (tâche PERSIST_TASK ou loop())
+ */
+void persistPoll();
+
+/**
+ * @brief Enregistre immédiatement tous les paramètres modifiés et écrit les
+ *        ajouts en cache des fichiers (logs)
+ *        Attend la fin d'une écriture en cours de la tâche PERSIST_TASK.
+ */
+void persistFlush();
+
+/**
+ * @brief Active l'enregistrement différé (fin de setup)
+ *        Avec PERSIST_TASK, démarre la tâche d'enregistrement.
+ */
+void persistInit();
+
+#endif
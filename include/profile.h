@@ -0,0 +1,72 @@
+/**
+ * @file profile.h
+ * @brief Mesure permanente des durées d'exécution par section.
+ *
+ * Chaque section (boucle principale, client MQTT, Alexa, logique locale,
+ * schedule, affichage, écritures LittleFS, gigue du cycle de scrutation)
+ * cumule ses durées dans un histogramme à classes fixes. Les histogrammes sont
+ * publiés sur demande (TOPIC_GET_PROFILE) puis remis à zéro.
+ *
+ * Coût d'une mesure : deux appels à micros() et une mise à jour sous spinlock.
+ */
+#ifndef PROFILE_H
+#define PROFILE_H
+#include <Arduino.h>
+
+// Sections mesurées
+enum ProfSection {
+  PROF_LOOP,         ///< Une itération de loop()
+  PROF_MQTT_LOOP,    ///< mqttClient.loop() (y compris PubSubCallback)
+  PROF_FAUXMO,       ///< fauxmo.handle()
+  PROF_LOCAL_LOOP,   ///< localLoop()
+  PROF_SCHEDULE,     ///< schedule()
+  PROF_DISPLAY,      ///< display() (LCD I2C)
+  PROF_FS_WRITE,     ///< FileLittleFS::writeFile()
+  PROF_SCAN_JITTER,  ///< Ecart entre deux débuts de cycle de scrutation et la période
+  PROF_N_SECTIONS
+};
+
+// Nombre de classes des histogrammes
+#define PROF_N_BUCKETS 8
+
+/**
+ * @brief Histogramme des durées d'une section en microsecondes
+ *        Classes : <100us, <500us, <1ms, <5ms, <10ms, <50ms, <100ms, >=100ms
+ *        La dernière classe correspond au dépassement de INTERVAL_IO_SCRUT.
+ */
+struct ProfHistogram {
+  unsigned long count;
+  unsigned long maxUs;
+  unsigned long buckets[PROF_N_BUCKETS];
+};
+
+/**
+ * @brief Ajoute une mesure à l'histogramme d'une section
+ * @param section 
+ * @param us durée en microsecondes
+ */
+void profRecord(ProfSection section, unsigned long us);
+
+/**
+ * @brief Copie les histogrammes et ouvre une nouvelle fenêtre de mesure
+ * @param histograms tableau de PROF_N_SECTIONS histogrammes
+ */
+void profTake(ProfHistogram* histograms);
+
+/**
+ * @brief Nom court d'une section (publication MQTT)
+ */
+const char* profName(int section);
+
+/**
+ * @brief Mesure la durée d'un bloc : de la construction à la sortie du bloc
+ */
+class ProfTimer {
+  ProfSection _section;
+  unsigned long _start;
+public:
+  ProfTimer(ProfSection section) : _section(section), _start(micros()) {}
+  ~ProfTimer() { profRecord(_section, micros() - _start); }
+};
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @file scan.h
+ * @brief Cycle de scrutation à période fixe (type automate).
+ *
+ * Un cycle : échantillonnage des entrées, logique locale (localLoop : commandes
+ * manuelles, surpresseur, logsUpdate), écriture des sorties (ioFlush).
+ *
+ * Avec SCAN_TASK (const.h) le cycle est exécuté par une tâche dédiée épinglée
+ * sur SCAN_TASK_CORE, loop() (réseau, Alexa, LCD, schedule) tournant sur l'autre
+ * coeur. Sans SCAN_TASK, loop() appelle scanCycle() toutes les INTERVAL_IO_SCRUT.
+ *
+ * La logique locale et loop() partagent l'état des dispositifs : ses
+ * modifications (commandes MQTT et Alexa, actions programmées, menus rotary,
+ * démarrage/arrêt des dispositifs) sont sérialisées par ctrlLock()/ctrlUnlock()
+ * (CtrlGuard), tenu le moins longtemps possible. L'afficheur a son propre
+ * verrou (LcdGuard, display.h) ; les écritures en mémoire flash, les
+ * compteurs et les publications MQTT en attente se font hors CtrlGuard.
+ */
+#ifndef SCAN_H
+#define SCAN_H
+#include <Arduino.h>
+#include "const.h"
+
+/**
+ * @brief Durées des cycles de scrutation en microsecondes
+ *        Fenêtre de mesure remise à zéro à chaque publication
+ */
+struct ScanStats {
+  unsigned long scans;       ///< Nombre de cycles
+  unsigned long minUs;       ///< Durée minimale d'un cycle
+  unsigned long maxUs;       ///< Durée maximale d'un cycle
+  unsigned long sumUs;       ///< Somme des durées (moyenne = sumUs / scans)
+  unsigned long maxJitterUs; ///< Ecart maximal entre deux débuts de cycle et la période
+  unsigned long overruns;    ///< Cycles plus longs que la période
+};
+
+/**
+ * @brief Démarre la tâche de scrutation (fin de setup)
+ */
+void initScanTask();
+
+/**
+ * @brief Un cycle de scrutation : entrées, logique locale, sorties
+ */
+void scanCycle();
+
+/**
+ * @brief Copie les statistiques et ouvre une nouvelle fenêtre de mesure
+ * @param stats copie des statistiques de la fenêtre écoulée
+ */
+void scanStatsTake(ScanStats* stats);
+
+// Exclusion mutuelle (récursive) entre la logique locale et loop()
+void ctrlLock();
+void ctrlUnlock();
+
+/**
+ * @brief Verrou de portée : libéré à la sortie du bloc (y compris return)
+ */
+class CtrlGuard {
+public:
+  CtrlGuard() { ctrlLock(); }
+  ~CtrlGuard() { ctrlUnlock(); }
+};
+
+#endif
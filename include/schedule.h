@@ -0,0 +1,113 @@
+/**
+ * @file schedule.h
+ * @brief Table des actions programmées précompilée à partir de Param.
+ *
+ * Les plages enable:HMin:MMin:HMax:MMax de Param sont converties en une liste
+ * d'événements triés par minute du jour (0..1439). schedule() n'a plus qu'à
+ * avancer un curseur dans cette liste toutes les minutes au lieu de parcourir
+ * N_DEVICES x N_PLAGES plages.
+ *
+ * La table est recompilée automatiquement dès que la version de Param change
+ * (setParam(), set(), setStr()).
+ */
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+#include <Arduino.h>
+#include "const.h"
+#include "param.h"
+
+// Nombre de minutes dans une journée
+#define MINUTES_PER_DAY (24 * 60)
+// Nombre maximum d'événements (une mise sous tension et une mise hors tension par plage)
+#define MAX_SCHEDULE_EVENTS (2 * N_PARAM)
+
+// Durée maximale de rattrapage des événements manqués (redémarrage, blocage de loop)
+// Doit rester inférieure à une demi-journée (détection du passage à minuit dans pop())
+#define MAX_CATCH_UP_MINUTES (6 * 60)
+
+// Type d'action d'un événement
+#define SCHED_OFF 0
+#define SCHED_ON  1
+
+/**
+ * @brief Evénement programmé : à minute donnée, action sur un dispositif
+ */
+struct ScheduleEvent {
+  uint16_t minute;    ///< Minute du jour (h * 60 + m)
+  uint8_t  deviceId;  ///< POWER_COOK, IRRIGATION, VANNE_EST, PAC, VMC
+  uint8_t  timeSet;   ///< Numéro de plage
+  uint8_t  action;    ///< SCHED_ON ou SCHED_OFF
+  uint8_t  enable;    ///< Niveau d'activation de la plage (1, 2 = VMC rapide)
+};
+
+/**
+ * @class Schedule
+ * @brief Liste triée des événements programmés et curseur sur le prochain événement.
+ */
+class Schedule {
+  ScheduleEvent _events[MAX_SCHEDULE_EVENTS];
+  int _nEvents;
+  int _cursor;
+  int _lastMinute;
+  unsigned _version;
+  boolean _compiled;
+
+public:
+  Schedule();
+
+  /**
+   * @brief Recompile la table si les paramètres ont changé depuis la dernière compilation
+   * @param param paramètres des plages horaires
+   */
+  void update(Param* param);
+
+  /**
+   * @brief Compile la table à partir des paramètres
+   *        Le curseur est repositionné après la dernière minute évaluée.
+   * @param param paramètres des plages horaires
+   */
+  void compile(Param* param);
+
+  /**
+   * @brief Positionne la dernière minute évaluée (au démarrage)
+   *        Les événements de minute > minuteOfDay seront déclenchés par pop().
+   * @param minuteOfDay 0..1439, -1 pour début de journée
+   */
+  void seek(int minuteOfDay);
+
+  /**
+   * @brief Mémorise en mémoire RTC la dernière minute évaluée
+   *        (conservée lors des redémarrages logiciels : ESP.restart, watchdog, OTA)
+   * @param epoch date courante en secondes
+   */
+  void save(unsigned long epoch);
+
+  /**
+   * @brief Reprend la dernière minute évaluée avant le redémarrage
+   *        Les événements manqués depuis seront retournés par pop().
+   * @param epoch date courante en secondes
+   * @return true si une minute valide de moins de MAX_CATCH_UP_MINUTES a été retrouvée
+   */
+  boolean restore(unsigned long epoch);
+
+  /**
+   * @brief Retourne l'événement suivant à déclencher au plus tard à minuteOfDay
+   *        et avance le curseur. Gère le passage à minuit.
+   * @param minuteOfDay minute courante 0..1439
+   * @return const ScheduleEvent* NULL si aucun événement n'est dû
+   */
+  const ScheduleEvent* pop(int minuteOfDay);
+
+  /**
+   * @brief Prochain événement programmé (sans avancer le curseur)
+   * @return const ScheduleEvent* NULL si la table est vide
+   */
+  const ScheduleEvent* next();
+
+  int size() { return _nEvents; }
+  int lastMinute() { return _lastMinute; }
+
+  void print();
+};
+
+#endif
@@ -3,46 +3,41 @@
  * @brief Header file for the SimpleParam class.
  * 
  * This file contains the definition of the SimpleParam class, which is used to manage parameters
- * represented in the form "param1<motif>param2<motif>...".
+ * represented in the form "param1:param2:...".
  * 
- * @note param = int, motif = string
+ * @note The parameters are described by a compile-time schema (param_schema.h).
  */
 
 /**
  * @class SimpleParam
- * @brief A class to manage parameters represented in a specific format.
+ * @brief A class to manage integer parameters described by a ParamSchema.
  * 
- * The SimpleParam class allows for the management of parameters represented in the form
- * "param1<motif>param2<motif>...". It provides methods to get and set individual parameters,
- * as well as to retrieve and update the entire parameter string.
- * 
- * @note param = int, motif = string
+ * Values are stored in a fixed-size array (no allocation) and kept within the
+ * bounds of the schema. The string "v0:v1:..." exchanged over MQTT is parsed in
+ * a single pass and rendered only when it is read after a modification.
  */
 
 #ifndef SIMPLE_PARAM_H
 #define SIMPLE_PARAM_H
 #include <Arduino.h>
 #include "const.h"
+#include "param_schema.h"
 
 class SimpleParam {
 private:
-  char* _motif;
-  char* _sparam;
-  char* _buffer;
-  int*  _param;
-  unsigned _nparam;
+  const ParamSchema& _schema;
+  int32_t _param[MAX_SCHEMA_FIELDS];
+  char _sparam[MAX_SCHEMA_FIELDS * 12];  ///< Entiers et séparateurs
+  boolean _dirty;                        ///< _sparam à reconstruire
+  char _error[64];                       ///< Dernière erreur de lecture, vide sinon
 
 public:
   /**
-   * @brief Construct a new Simple Param object
+   * @brief Construct a new Simple Param object initialised with the schema defaults
    * 
-   * @param str chaine contenant les paramètres
-   * @param motif chaine contenant le motif
-   * @param nParam nombre de paramètres dans str
+   * @param schema description des paramètres
    */
-  SimpleParam(const char* str, const char* motif, unsigned nParam);
-
-  ~SimpleParam();
+  SimpleParam(const ParamSchema& schema);
 
   /**
    *@brief Get param
@@ -54,7 +49,7 @@ public:
   int get(int nParam);
 
   /**
-   *@brief modifie un paramètre
+   *@brief modifie un paramètre, valeur ramenée dans les bornes du schéma
    * 
    * @param nParam  numéro du paramètre
    * @param val   valeur du paramètre
@@ -69,16 +64,44 @@ public:
   char* getStr();
   /**
    *@brief Set the Str param
+   *       Les valeurs courantes sont conservées si la chaine est invalide.
    * 
    * @param str str param
+   * @param clamp false : toutes les valeurs sont exigées, une valeur hors bornes
+   *              est une erreur (MQTT). true : valeurs ramenées dans les bornes,
+   *              les derniers paramètres absents gardent leur valeur (anciens fichiers)
+   * @return true si la chaine est valide
    */
-  
-  void  setStr(const char* str);
+  boolean setStr(const char* str, boolean clamp = false);
+
+  /**
+   *@brief Nombre de paramètres
+   */
+  unsigned size() { return _schema.size; }
+
+  /**
+   *@brief Description des paramètres
+   */
+  const ParamSchema& schema() { return _schema; }
+
+  /**
+   *@brief Modifie les n premiers paramètres (valeurs ramenées dans les bornes)
+   * 
+   * @param values valeurs des paramètres
+   * @param n nombre de valeurs, limité à size()
+   */
+  void  setValues(const int32_t* values, unsigned n);
+
+  /**
+   *@brief Description de la dernière erreur de lecture
+   * 
+   * @return NULL si la dernière lecture a réussi
+   */
+  const char* error() { return _error[0] ? _error : NULL; }
   
   void  print();
 
 private:
-  void  split();
-  int   update();
+  int32_t clampValue(int nParam, int32_t val);
 };
-#endif
\ No newline at end of file
+#endif
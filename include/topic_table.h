@@ -0,0 +1,98 @@
+/**
+ * @file topic_table.h
+ * @brief Table de répartition des messages MQTT reçus.
+ *
+ * Chaque topic d'abonnement est associé à sa fonction de traitement dans une
+ * table triée sur le nom du topic. La même table sert aux abonnements
+ * (subscribeTopics) et à la recherche du traitement d'un message
+ * (findTopic) : ajouter un topic revient à ajouter une ligne à la table.
+ *
+ * Tous les topics commencent par TOPIC_ROOT, vérifié une seule fois par
+ * message ; la recherche dichotomique ne compare que la suite du nom. L'ordre
+ * et le préfixe des entrées sont vérifiés à la compilation (topicsSorted).
+ *
+ * Les traitements reçoivent une vue (pointeur, longueur) sur le tampon de
+ * PubSubClient, sans allocation : les commandes numériques sont lues sur place
+ * (toInt), seuls les paramètres texte sont copiés une fois (text).
+ */
+#ifndef TOPIC_TABLE_H
+#define TOPIC_TABLE_H
+#include <Arduino.h>
+#include <PubSubClient.h>
+#include "const.h"
+
+// Préfixe commun des topics d'abonnement
+#define TOPIC_ROOT TOPIC_PREFIX "homecontrol/"
+
+/**
+ * @brief Vue sur le contenu d'un message reçu (tampon de PubSubClient,
+ *        valide pendant le traitement du message)
+ */
+struct TopicPayload {
+  const char* data;
+  unsigned length;
+
+  /**
+   * @brief Entier en tête du message, comme atol (0 si absent)
+   */
+  long toInt() const;
+
+  /**
+   * @brief Copie terminée par '\0' dans un tampon partagé
+   *        (valide jusqu'au message suivant)
+   * @return const char* chaine vide si le message dépasse MQTT_MAX_PACKET_SIZE
+   */
+  const char* text() const;
+};
+
+/**
+ * @brief Traitement d'un message reçu
+ */
+typedef void (*TopicCallback)(const TopicPayload& payload);
+
+struct TopicHandler {
+  const char* topic;
+  TopicCallback callback;
+};
+
+/**
+ * @brief Comparaison de chaines évaluable à la compilation
+ */
+constexpr int topicCompare(const char* s1, const char* s2) {
+  return *s1 != *s2 || !*s1 ? (unsigned char)*s1 - (unsigned char)*s2 : topicCompare(s1 + 1, s2 + 1);
+}
+
+/**
+ * @brief s commence par prefix (évaluable à la compilation)
+ */
+constexpr bool topicRooted(const char* s, const char* prefix) {
+  return !*prefix || (*s == *prefix && topicRooted(s + 1, prefix + 1));
+}
+
+/**
+ * @brief Table triée, sans doublon, topics commençant par TOPIC_ROOT
+ *        (à utiliser dans un static_assert)
+ */
+constexpr bool topicsSorted(const TopicHandler* table, size_t size) {
+  return size == 0 ||
+         (topicRooted(table[0].topic, TOPIC_ROOT) &&
+          (size == 1 || topicCompare(table[0].topic, table[1].topic) < 0) &&
+          topicsSorted(table + 1, size - 1));
+}
+
+/**
+ * @brief Recherche du traitement d'un topic
+ * @param table table triée
+ * @param size nombre d'entrées
+ * @param topic topic reçu
+ * @return const TopicHandler* NULL si le topic n'est pas dans la table
+ */
+const TopicHandler* findTopic(const TopicHandler* table, size_t size, const char* topic);
+
+/**
+ * @brief Abonnement à tous les topics de la table
+ * @return true si tous les abonnements sont acceptés
+ */
+boolean subscribeTopics(PubSubClient& client, const TopicHandler* table, size_t size);
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @file wifi_cache.h
+ * @brief Connexion WiFi directe : point d'accès, canal et adresse mémorisés.
+ *
+ * Après chaque connexion, le BSSID et le canal du point d'accès sont conservés
+ * en mémoire RTC (redémarrage logiciel, dont le redémarrage quotidien) et dans
+ * WIFI_CACHE_FILE_NAME en cas de changement (mise sous tension). La connexion
+ * suivante s'adresse directement à ce point d'accès, sans recherche sur tous
+ * les canaux ; en cas d'échec (WIFI_DIRECT_TIMEOUT) le cache est oublié et une
+ * recherche complète est lancée.
+ *
+ * Adresse IP : WIFI_STATIC_IP (const.h) si elle est définie, sinon DHCP. Un
+ * bail obtenu depuis moins de WIFI_LEASE_REUSE est réutilisé sans échange DHCP
+ * (mémoire RTC uniquement) ; au-delà, le bail a pu être attribué à un autre
+ * appareil. Pour supprimer l'échange DHCP à chaque redémarrage quotidien,
+ * réserver l'adresse sur le routeur et définir WIFI_STATIC_IP.
+ */
+#ifndef WIFI_CACHE_H
+#define WIFI_CACHE_H
+#include <Arduino.h>
+#include <WiFi.h>
+#include "const.h"
+
+/**
+ * @brief Compteurs depuis le démarrage
+ */
+struct WifiCacheStats {
+  uint32_t direct;          ///< Connexions directes (point d'accès mémorisé)
+  uint32_t directFailures;  ///< Echecs de connexion directe
+  uint32_t scans;           ///< Connexions après recherche complète
+  uint32_t bootConnect;     ///< Durée de la première connexion (ms)
+  uint32_t lastConnect;     ///< Durée de la dernière connexion (ms)
+  uint32_t lastDirect;      ///< Dernière connexion directe
+};
+
+/**
+ * @brief Reprend le cache : mémoire RTC, sinon WIFI_CACHE_FILE_NAME
+ *        (setup, avant la connexion WiFi)
+ */
+void wifiCacheInit();
+
+/**
+ * @brief Lance la connexion (WiFi.begin, non bloquant), mode WIFI_STA
+ *        La durée de connexion est mesurée depuis le premier appel.
+ * @return true si la connexion est directe
+ */
+boolean wifiCacheBegin(const char* ssid, const char* password);
+
+/**
+ * @brief Connexion établie : point d'accès et bail mémorisés
+ */
+void wifiCacheConnected();
+
+/**
+ * @brief Echec de la connexion
+ * @return true si la connexion directe a échoué : cache oublié, une
+ *         recherche complète doit être lancée aussitôt (wifiCacheBegin)
+ */
+boolean wifiCacheFailed();
+
+/**
+ * @brief Copie des compteurs
+ */
+void wifiCacheStatsTake(WifiCacheStats* stats);
+
+#endif
@@ -0,0 +1,28 @@
+/**
+ * @file AiEsp32RotaryEncoder.h
+ * @brief Codeur rotatif de la couche native : valeur positionnée par halRotate().
+ */
+#ifndef HAL_AIESP32ROTARYENCODER_H
+#define HAL_AIESP32ROTARYENCODER_H
+#include <Arduino.h>
+#include <cstdint>
+
+class AiEsp32RotaryEncoder {
+  long _value = 0, _last = 0, _min = 0, _max = 0;
+  bool _circle = false;
+public:
+  AiEsp32RotaryEncoder(uint8_t, uint8_t, int, int, uint8_t = 4) {}
+  void begin() {}
+  void setup(void (*)()) {}
+  void readEncoder_ISR() {}
+  void setBoundaries(long min, long max, bool circle = false) { _min = min; _max = max; _circle = circle; }
+  void setEncoderValue(long value) { _value = _last = value; }
+  long readEncoder() { return _value; }
+  long encoderChanged() { long d = _value - _last; _last = _value; return d; }
+  void halRotate(long steps) {
+    _value += steps;
+    if (_value > _max) _value = _circle ? _min : _max;
+    if (_value < _min) _value = _circle ? _max : _min;
+  }
+};
+#endif
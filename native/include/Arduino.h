@@ -0,0 +1,103 @@
+/**
+ * @file Arduino.h
+ * @brief Couche d'abstraction native (Linux) : sous-ensemble du framework
+ *        Arduino ESP32 utilisé par le projet.
+ *
+ * Environnement PlatformIO "native" uniquement. Le temps est fourni par
+ * hal_time (horloge réelle par défaut), les broches sont simulées en mémoire.
+ */
+#ifndef HAL_ARDUINO_H
+#define HAL_ARDUINO_H
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdarg>
+#include <cmath>
+#include <climits>
+#include <ctime>
+#include <string>
+#include <algorithm>
+#include <type_traits>
+#include "hal_time.h"
+#include "freertos_hal.h"
+#include "WString.h"
+#include "HardwareSerial.h"
+#include "Esp.h"
+#include "binary.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef unsigned long ulong;
+typedef unsigned int uint;
+
+#define HIGH 1
+#define LOW  0
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+#define RISING  0x01
+#define FALLING 0x02
+#define CHANGE  0x03
+
+#define HEX 16
+#define DEC 10
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+// Variables conservées lors d'un ESP.restart() : section copiée d'un démarrage
+// à l'autre par le simulateur (__start_rtc_noinit .. __stop_rtc_noinit)
+#define RTC_NOINIT_ATTR __attribute__((section("rtc_noinit")))
+#define F(s) (s)
+
+typedef enum {
+  GPIO_NUM_0 = 0, GPIO_NUM_2 = 2, GPIO_NUM_4 = 4, GPIO_NUM_5 = 5,
+  GPIO_NUM_12 = 12, GPIO_NUM_13 = 13, GPIO_NUM_14 = 14, GPIO_NUM_15 = 15,
+  GPIO_NUM_16 = 16, GPIO_NUM_17 = 17, GPIO_NUM_18 = 18, GPIO_NUM_19 = 19,
+  GPIO_NUM_21 = 21, GPIO_NUM_22 = 22, GPIO_NUM_23 = 23, GPIO_NUM_25 = 25,
+  GPIO_NUM_26 = 26, GPIO_NUM_27 = 27, GPIO_NUM_32 = 32, GPIO_NUM_33 = 33,
+  GPIO_NUM_34 = 34, GPIO_NUM_35 = 35, GPIO_NUM_36 = 36, GPIO_NUM_39 = 39,
+  GPIO_NUM_MAX = 40
+} gpio_num_t;
+
+inline unsigned long millis() { return halMicros() / 1000; }
+inline unsigned long micros() { return (unsigned long)halMicros(); }
+void delay(unsigned long ms);
+void yield();
+void delayMicroseconds(unsigned int us);
+
+// Broches simulées (hal_gpio.cpp)
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+uint8_t digitalPinToInterrupt(uint8_t pin);
+// Positionne le niveau lu sur une broche d'entrée
+void halSetPin(uint8_t pin, int val);
+
+// Conversions de la libc newlib absentes de la glibc
+char* itoa(int value, char* buffer, int base);
+char* utoa(unsigned value, char* buffer, int base);
+char* ltoa(long value, char* buffer, int base);
+#if !defined(__GLIBC__) || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38)
+size_t strlcpy(char* dst, const char* src, size_t size);
+#endif
+
+using std::min;
+using std::max;
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+// Retour par valeur : decltype() sur les paramètres donnerait une référence à une variable locale
+template <class T, class L, class H>
+inline typename std::common_type<T, L, H>::type constrain(T x, L low, H high) {
+  return x < low ? low : (x > high ? high : x);
+}
+
+void setup();
+void loop();
+#endif
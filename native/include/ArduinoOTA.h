@@ -0,0 +1,21 @@
+/**
+ * @file ArduinoOTA.h
+ * @brief Mise à jour OTA de la couche native : sans effet.
+ *        Inclut WiFi.h comme la bibliothèque ESP32.
+ */
+#ifndef HAL_ARDUINO_OTA_H
+#define HAL_ARDUINO_OTA_H
+#include <Arduino.h>
+#include <functional>
+#include "WiFi.h"
+
+class ArduinoOTAClass {
+public:
+  void setHostname(const char*) {}
+  ArduinoOTAClass& onEnd(std::function<void()>) { return *this; }
+  void begin() {}
+  void handle() {}
+};
+
+extern ArduinoOTAClass ArduinoOTA;
+#endif
@@ -0,0 +1,54 @@
+/**
+ * @file ESP32Time.h
+ * @brief Horloge ESP32Time sur l'heure système de la couche native.
+ */
+#ifndef HAL_ESP32TIME_H
+#define HAL_ESP32TIME_H
+#include <ctime>
+#include "WString.h"
+#include "hal_time.h"
+
+class ESP32Time {
+  long _offset;
+  struct tm now() const {
+    time_t t = halEpoch() + _offset;
+    struct tm info;
+    gmtime_r(&t, &info);
+    return info;
+  }
+public:
+  ESP32Time(long offset = 0) : _offset(offset) {}
+  void setTime(int sc, int mn, int hr, int dy, int mt, int yr, int ms = 0) {
+    struct tm info = {};
+    info.tm_sec = sc;
+    info.tm_min = mn;
+    info.tm_hour = hr;
+    info.tm_mday = dy;
+    info.tm_mon = mt;
+    info.tm_year = yr - 1900;
+    halSetEpoch(timegm(&info));
+  }
+  // Comme la bibliothèque : le décalage n'est appliqué qu'en lecture
+  void setTimeStruct(struct tm info) { halSetEpoch(timegm(&info)); }
+  void setTime(unsigned long epoch) { halSetEpoch(epoch); }
+  unsigned long getEpoch() { return halEpoch(); }
+  unsigned long getLocalEpoch() { return halEpoch() + _offset; }
+  int getSecond() { return now().tm_sec; }
+  int getMinute() { return now().tm_min; }
+  int getHour(bool mode = false) {
+    int h = now().tm_hour;
+    return mode ? h : (h % 12 == 0 ? 12 : h % 12);
+  }
+  int getDay() { return now().tm_mday; }
+  int getDayofWeek() { return now().tm_wday; }
+  int getDayofYear() { return now().tm_yday; }
+  int getMonth() { return now().tm_mon; }
+  int getYear() { return now().tm_year + 1900; }
+  String getDateTime(bool mode = false) {
+    char buffer[40];
+    struct tm info = now();
+    strftime(buffer, sizeof(buffer), mode ? "%A, %B %d %Y %H:%M:%S" : "%a, %b %d %Y %H:%M:%S", &info);
+    return String(buffer);
+  }
+};
+#endif
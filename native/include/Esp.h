@@ -0,0 +1,33 @@
+/**
+ * @file Esp.h
+ * @brief Classe ESP de la couche native.
+ */
+#ifndef HAL_ESP_H
+#define HAL_ESP_H
+#include <cstdint>
+
+/**
+ * @brief Levée par ESP.restart() : le programme natif relance setup()
+ */
+struct HalRestart {};
+
+typedef enum {
+  ESP_RST_UNKNOWN, ESP_RST_POWERON, ESP_RST_EXT, ESP_RST_SW, ESP_RST_PANIC,
+  ESP_RST_INT_WDT, ESP_RST_TASK_WDT, ESP_RST_WDT, ESP_RST_DEEPSLEEP,
+  ESP_RST_BROWNOUT, ESP_RST_SDIO
+} esp_reset_reason_t;
+
+// ESP_RST_POWERON au premier setup(), ESP_RST_SW après ESP.restart()
+esp_reset_reason_t esp_reset_reason();
+void halSetResetReason(esp_reset_reason_t reason);
+
+class EspClass {
+public:
+  [[noreturn]] void restart();
+  uint32_t getFreeHeap() { return 200000; }
+  uint32_t getMinFreeHeap() { return 150000; }
+  uint32_t getHeapSize() { return 320000; }
+};
+
+extern EspClass ESP;
+#endif
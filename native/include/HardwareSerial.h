@@ -0,0 +1,44 @@
+/**
+ * @file HardwareSerial.h
+ * @brief Port série de la couche native : sortie standard.
+ */
+#ifndef HAL_HARDWARE_SERIAL_H
+#define HAL_HARDWARE_SERIAL_H
+#include <cstdio>
+#include <cstdarg>
+#include <cstdint>
+#include <cstring>
+#include "WString.h"
+
+class HardwareSerial {
+public:
+  void begin(unsigned long) {}
+  void end() {}
+  int available() { return 0; }
+  int read() { return -1; }
+  void flush() { fflush(stdout); }
+  operator bool() const { return true; }
+
+  size_t write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+  size_t print(const char* s) { return fputs(s, stdout) < 0 ? 0 : strlen(s); }
+  size_t print(const String& s) { return print(s.c_str()); }
+  size_t print(char c) { return write(c); }
+  size_t print(int v, int base = 10) { return printf(base == 16 ? "%x" : "%d", v); }
+  size_t print(unsigned v, int base = 10) { return printf(base == 16 ? "%x" : "%u", v); }
+  size_t print(long v, int base = 10) { return printf(base == 16 ? "%lx" : "%ld", v); }
+  size_t print(unsigned long v, int base = 10) { return printf(base == 16 ? "%lx" : "%lu", v); }
+  size_t print(double v, int decimals = 2) { return printf("%.*f", decimals, v); }
+  size_t println() { return print("\n"); }
+  template <class T> size_t println(T v) { size_t n = print(v); return n + println(); }
+  template <class T> size_t println(T v, int format) { size_t n = print(v, format); return n + println(); }
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    va_list args;
+    va_start(args, format);
+    int n = vprintf(format, args);
+    va_end(args);
+    return n < 0 ? 0 : n;
+  }
+};
+
+extern HardwareSerial Serial;
+#endif
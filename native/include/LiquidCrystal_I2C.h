@@ -0,0 +1,47 @@
+/**
+ * @file LiquidCrystal_I2C.h
+ * @brief Afficheur LCD 20x4 de la couche native : tampon mémoire.
+ */
+#ifndef HAL_LIQUIDCRYSTAL_I2C_H
+#define HAL_LIQUIDCRYSTAL_I2C_H
+#include <cstdint>
+#include <cstring>
+#include "Wire.h"
+#include "WString.h"
+
+#define PCF8574_ADDR_A21_A11_A01  0x27
+#define PCF8574A_ADDR_A21_A11_A01 0x3F
+#define LCD_5x8DOTS  0x00
+#define LCD_5x10DOTS 0x04
+typedef enum { POSITIVE, NEGATIVE } backlightPolarity;
+
+class LiquidCrystal_I2C {
+  char _screen[4][21];
+  uint8_t _col = 0, _row = 0;
+  bool _display = true;
+public:
+  LiquidCrystal_I2C(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t,
+                    uint8_t, uint8_t, backlightPolarity) { clear(); }
+  bool begin(uint8_t, uint8_t, uint8_t = LCD_5x8DOTS, int = -1, int = -1, uint32_t = 0, uint32_t = 0) { return true; }
+  void clear() { memset(_screen, ' ', sizeof(_screen)); for (auto& l : _screen) l[20] = 0; _col = _row = 0; }
+  void home() { _col = _row = 0; }
+  void setCursor(uint8_t col, uint8_t row) { _col = col; _row = row; }
+  void displayOn() { _display = true; }
+  void displayOff() { _display = false; }
+  void backlight() {}
+  void noBacklight() {}
+  void createChar(uint8_t, const uint8_t*) {}
+  size_t write(uint8_t c) {
+    if (_row < 4 && _col < 20)
+      _screen[_row][_col++] = c < ' ' ? '*' : c;
+    return 1;
+  }
+  size_t print(const char* s) { size_t n = 0; while (*s) n += write(*s++); return n; }
+  size_t print(const String& s) { return print(s.c_str()); }
+  size_t print(char c) { return write(c); }
+  size_t print(int v) { char b[12]; snprintf(b, sizeof(b), "%d", v); return print(b); }
+  // Contenu d'une ligne de l'afficheur
+  const char* halLine(int row) const { return _screen[row & 3]; }
+  bool halDisplayOn() const { return _display; }
+};
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file LittleFS.h
+ * @brief Système de fichiers de la couche native : fichiers en mémoire.
+ *
+ * Le contenu est perdu à la fin du programme. halFiles()/halSetFiles()
+ * permettent au simulateur de conserver les fichiers lors d'un ESP.restart().
+ */
+#ifndef HAL_LITTLEFS_H
+#define HAL_LITTLEFS_H
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include "WString.h"
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File {
+  std::shared_ptr<std::string> _data;
+  std::string _path;
+  size_t _position = 0;
+  bool _write = false;
+public:
+  File() {}
+  File(std::shared_ptr<std::string> data, const char* path, const char* mode);
+  operator bool() const { return (bool)_data; }
+  size_t write(uint8_t c) { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size);
+  size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t print(const String& s) { return print(s.c_str()); }
+  size_t println(const char* s) { return print(s) + print("\n"); }
+  int available() { return _data ? (int)(_data->size() - _position) : 0; }
+  int read();
+  size_t read(uint8_t* buffer, size_t size);
+  int peek() { return available() ? (uint8_t)(*_data)[_position] : -1; }
+  String readString();
+  String readStringUntil(char terminator);
+  bool seek(uint32_t position, SeekMode mode = SeekSet);
+  size_t position() const { return _position; }
+  size_t size() const { return _data ? _data->size() : 0; }
+  const char* path() const { return _path.c_str(); }
+  const char* name() const;
+  void flush() {}
+  void close() { _data.reset(); }
+};
+
+class LittleFSFS {
+  std::map<std::string, std::shared_ptr<std::string>> _files;
+public:
+  bool begin(bool formatOnFail = false, const char* basePath = "/littlefs",
+             uint8_t maxOpenFiles = 10, const char* partitionLabel = "spiffs") { return true; }
+  void end() {}
+  bool format() { _files.clear(); return true; }
+  File open(const char* path, const char* mode = FILE_READ, bool create = false);
+  File open(const String& path, const char* mode = FILE_READ) { return open(path.c_str(), mode); }
+  bool exists(const char* path) { return _files.count(path) != 0; }
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path) { return _files.erase(path) != 0; }
+  bool rename(const char* from, const char* to);
+  bool mkdir(const char*) { return true; }
+  bool rmdir(const char*) { return true; }
+  size_t totalBytes() { return 1441792; }
+  size_t usedBytes();
+  // Contenu de la mémoire flash simulée
+  std::map<std::string, std::string> halFiles();
+  void halSetFiles(const std::map<std::string, std::string>& files);
+};
+
+extern LittleFSFS LittleFS;
+#endif
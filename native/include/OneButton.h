@@ -0,0 +1,32 @@
+/**
+ * @file OneButton.h
+ * @brief Bouton de la couche native : clics simulés par halClick().
+ */
+#ifndef HAL_ONEBUTTON_H
+#define HAL_ONEBUTTON_H
+#include <Arduino.h>
+
+typedef void (*callbackFunction)(void);
+
+class OneButton {
+  callbackFunction _click = nullptr, _doubleClick = nullptr, _multiClick = nullptr;
+  callbackFunction _longPressStart = nullptr, _longPressStop = nullptr;
+  int _clicks = 0;
+public:
+  OneButton(int, bool = true, bool = true) {}
+  void attachClick(callbackFunction f) { _click = f; }
+  void attachDoubleClick(callbackFunction f) { _doubleClick = f; }
+  void attachMultiClick(callbackFunction f) { _multiClick = f; }
+  void attachLongPressStart(callbackFunction f) { _longPressStart = f; }
+  void attachLongPressStop(callbackFunction f) { _longPressStop = f; }
+  void setPressTicks(int) {}
+  void setClickTicks(int) {}
+  int getNumberClicks() { return _clicks; }
+  void tick() {}
+  void halClick(int clicks = 1) {
+    _clicks = clicks;
+    callbackFunction f = clicks == 1 ? _click : clicks == 2 ? _doubleClick : _multiClick;
+    if (f) f();
+  }
+};
+#endif
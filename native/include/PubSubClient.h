@@ -0,0 +1,53 @@
+/**
+ * @file PubSubClient.h
+ * @brief Client MQTT de la couche native : courtier simulé en mémoire.
+ *
+ * - publish() transmet le message au crochet halMqttOnPublish (trace, simulateur)
+ * - halMqttInject() met un message en file, délivré au callback par loop()
+ *   si le topic a été souscrit (filtres exacts et '#' final)
+ * - la connexion est perdue avec le WiFi simulé (WiFi.halSetConnected)
+ */
+#ifndef HAL_PUBSUBCLIENT_H
+#define HAL_PUBSUBCLIENT_H
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <deque>
+#include "WiFi.h"
+
+#define MQTT_MAX_PACKET_SIZE 512
+#define MQTT_CALLBACK_SIGNATURE std::function<void(char*, uint8_t*, unsigned int)> callback
+
+// Crochet appelé pour chaque publication du client
+extern void (*halMqttOnPublish)(const char* topic, const char* payload);
+
+// Message reçu du courtier simulé
+void halMqttInject(const char* topic, const char* payload);
+
+class PubSubClient {
+  MQTT_CALLBACK_SIGNATURE;
+  bool _connected = false;
+  std::vector<std::string> _subscriptions;
+  bool subscribed(const std::string& topic) const;
+public:
+  PubSubClient() {}
+  PubSubClient(WiFiClient&) {}
+  PubSubClient& setServer(const char*, uint16_t) { return *this; }
+  PubSubClient& setCallback(MQTT_CALLBACK_SIGNATURE) { this->callback = callback; return *this; }
+  bool setBufferSize(uint16_t) { return true; }
+  PubSubClient& setSocketTimeout(uint16_t) { return *this; }
+  // Connexion perdue avec le WiFi simulé (commande wifi du simulateur)
+  bool connect(const char*) { return _connected = WiFi.isConnected(); }
+  bool connect(const char*, const char*, const char*) { return _connected = WiFi.isConnected(); }
+  void disconnect() { _connected = false; }
+  bool connected() { return _connected = _connected && WiFi.isConnected(); }
+  int state() { return _connected ? 0 : -1; }
+  bool publish(const char* topic, const char* payload);
+  bool publish(const char* topic, const char* payload, bool retained);
+  bool publish(const char* topic, const uint8_t* payload, unsigned int length, bool retained = false);
+  bool subscribe(const char* topic, uint8_t qos = 0);
+  bool unsubscribe(const char* topic);
+  bool loop();
+};
+#endif
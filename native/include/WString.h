@@ -0,0 +1,96 @@
+/**
+ * @file WString.h
+ * @brief Classe String Arduino (sous-ensemble) sur std::string.
+ */
+#ifndef HAL_WSTRING_H
+#define HAL_WSTRING_H
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+
+class String {
+  std::string _s;
+public:
+  String() {}
+  String(const char* s) : _s(s ? s : "") {}
+  String(const std::string& s) : _s(s) {}
+  String(char c) : _s(1, c) {}
+  String(int v, unsigned char base = 10) { fromLong(v, base); }
+  String(unsigned v, unsigned char base = 10) { fromULong(v, base); }
+  String(long v, unsigned char base = 10) { fromLong(v, base); }
+  String(unsigned long v, unsigned char base = 10) { fromULong(v, base); }
+  String(float v, unsigned char decimals = 2) { fromDouble(v, decimals); }
+  String(double v, unsigned char decimals = 2) { fromDouble(v, decimals); }
+
+  const char* c_str() const { return _s.c_str(); }
+  unsigned length() const { return _s.length(); }
+  bool isEmpty() const { return _s.empty(); }
+  long toInt() const { return atol(_s.c_str()); }
+  float toFloat() const { return atof(_s.c_str()); }
+  char charAt(unsigned i) const { return i < _s.length() ? _s[i] : 0; }
+  char operator[](unsigned i) const { return charAt(i); }
+  int indexOf(char c, unsigned from = 0) const {
+    size_t p = _s.find(c, from);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  int indexOf(const String& s, unsigned from = 0) const {
+    size_t p = _s.find(s._s, from);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  String substring(unsigned from) const { return from < _s.length() ? String(_s.substr(from)) : String(); }
+  String substring(unsigned from, unsigned to) const {
+    return from < to && from < _s.length() ? String(_s.substr(from, to - from)) : String();
+  }
+  bool startsWith(const String& s) const { return _s.compare(0, s._s.length(), s._s) == 0; }
+  bool equals(const String& s) const { return _s == s._s; }
+  void trim() {
+    size_t b = _s.find_first_not_of(" \t\r\n");
+    size_t e = _s.find_last_not_of(" \t\r\n");
+    _s = b == std::string::npos ? "" : _s.substr(b, e - b + 1);
+  }
+  bool concat(const String& s) { _s += s._s; return true; }
+  bool concat(const char* s) { _s += s ? s : ""; return true; }
+  bool concat(char c) { _s += c; return true; }
+
+  String& operator+=(const String& s) { _s += s._s; return *this; }
+  String& operator+=(const char* s) { _s += s ? s : ""; return *this; }
+  String& operator+=(char c) { _s += c; return *this; }
+  String& operator+=(int v) { return *this += String(v); }
+  String& operator+=(unsigned v) { return *this += String(v); }
+  String& operator+=(long v) { return *this += String(v); }
+  String& operator+=(unsigned long v) { return *this += String(v); }
+
+  friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+  friend String operator+(const String& a, const char* b) { return String(a._s + (b ? b : "")); }
+  friend String operator+(const char* a, const String& b) { return String((a ? a : "") + b._s); }
+  friend String operator+(const String& a, char b) { return String(a._s + b); }
+  friend String operator+(const String& a, int b) { return a + String(b); }
+  friend String operator+(const String& a, unsigned b) { return a + String(b); }
+  friend String operator+(const String& a, long b) { return a + String(b); }
+  friend String operator+(const String& a, unsigned long b) { return a + String(b); }
+  bool operator==(const String& s) const { return _s == s._s; }
+  bool operator==(const char* s) const { return _s == (s ? s : ""); }
+  bool operator!=(const String& s) const { return _s != s._s; }
+  bool operator!=(const char* s) const { return !(*this == s); }
+  bool operator<(const String& s) const { return _s < s._s; }
+
+private:
+  void fromULong(unsigned long v, unsigned char base) {
+    char buffer[40];
+    if (base == 16) snprintf(buffer, sizeof(buffer), "%lx", v);
+    else snprintf(buffer, sizeof(buffer), "%lu", v);
+    _s = buffer;
+  }
+  void fromLong(long v, unsigned char base) {
+    if (base != 10) { fromULong((unsigned long)v, base); return; }
+    char buffer[40];
+    snprintf(buffer, sizeof(buffer), "%ld", v);
+    _s = buffer;
+  }
+  void fromDouble(double v, unsigned char decimals) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", decimals, v);
+    _s = buffer;
+  }
+};
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file WiFi.h
+ * @brief WiFi de la couche native : toujours connecté, sans réseau réel.
+ */
+#ifndef HAL_WIFI_H
+#define HAL_WIFI_H
+#include <cstdint>
+#include <cstdio>
+#include "WString.h"
+
+typedef enum { WIFI_OFF, WIFI_STA, WIFI_AP, WIFI_AP_STA } wifi_mode_t;
+typedef enum { WIFI_POWER_19_5dBm = 78 } wifi_power_t;
+typedef enum { WL_IDLE_STATUS = 0, WL_CONNECTED = 3, WL_CONNECT_FAILED = 4, WL_DISCONNECTED = 6 } wl_status_t;
+
+class IPAddress {
+  uint8_t _a[4];
+public:
+  IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : _a{a, b, c, d} {}
+  String toString() const {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", _a[0], _a[1], _a[2], _a[3]);
+    return String(buffer);
+  }
+  uint8_t operator[](int i) const { return _a[i]; }
+};
+
+class WiFiClass {
+  bool _connected = true;
+public:
+  static bool setHostname(const char*) { return true; }
+  bool mode(wifi_mode_t) { return true; }
+  wl_status_t begin(const char*, const char* = nullptr) { return status(); }
+  wl_status_t begin(const char*, const char*, int32_t, const uint8_t*, bool = true) { return status(); }
+  bool config(IPAddress, IPAddress, IPAddress, IPAddress = IPAddress(), IPAddress = IPAddress()) { return true; }
+  wl_status_t status() { return _connected ? WL_CONNECTED : WL_DISCONNECTED; }
+  uint8_t waitForConnectResult(unsigned long = 60000) { return status(); }
+  bool isConnected() { return _connected; }
+  bool reconnect() { return _connected; }
+  bool disconnect(bool = false) { _connected = false; return true; }
+  bool setAutoReconnect(bool) { return true; }
+  void persistent(bool) {}
+  bool setTxPower(wifi_power_t) { return true; }
+  bool enableAP(bool) { return true; }
+  bool softAP(const char*, const char* = nullptr) { return true; }
+  int8_t RSSI() { return -60; }
+  String SSID() { return String("native"); }
+  IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+  IPAddress gatewayIP() { return IPAddress(127, 0, 0, 254); }
+  IPAddress subnetMask() { return IPAddress(255, 255, 255, 0); }
+  IPAddress dnsIP(uint8_t = 0) { return IPAddress(127, 0, 0, 254); }
+  uint8_t* BSSID() { static uint8_t bssid[6] = { 0x02, 0, 0, 0, 0, 1 }; return bssid; }
+  int32_t channel() { return 6; }
+  // Simulation d'une perte de connexion
+  void halSetConnected(bool connected) { _connected = connected; }
+};
+
+extern WiFiClass WiFi;
+
+class WiFiClient {
+public:
+  int connect(const char*, uint16_t) { return 1; }
+  bool connected() { return true; }
+  void stop() {}
+};
+#endif
@@ -0,0 +1,13 @@
+/**
+ * @file WiFiManager.h
+ * @brief WiFiManager de la couche native (non utilisé).
+ */
+#ifndef HAL_WIFIMANAGER_H
+#define HAL_WIFIMANAGER_H
+#include "WiFi.h"
+
+class WiFiManager {
+public:
+  bool autoConnect(const char*, const char* = nullptr) { return true; }
+};
+#endif
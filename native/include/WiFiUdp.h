@@ -0,0 +1,14 @@
+/**
+ * @file WiFiUdp.h
+ * @brief UDP de la couche native (non utilisé).
+ */
+#ifndef HAL_WIFIUDP_H
+#define HAL_WIFIUDP_H
+#include "WiFi.h"
+
+class WiFiUDP {
+public:
+  uint8_t begin(uint16_t) { return 1; }
+  void stop() {}
+};
+#endif
@@ -0,0 +1,15 @@
+/**
+ * @file Wire.h
+ * @brief Bus I2C de la couche native : sans effet.
+ */
+#ifndef HAL_WIRE_H
+#define HAL_WIRE_H
+#include <cstdint>
+
+class TwoWire {
+public:
+  bool begin(int = -1, int = -1, uint32_t = 0) { return true; }
+};
+
+extern TwoWire Wire;
+#endif
@@ -0,0 +1,16 @@
+/**
+ * @file esp_task_wdt.h
+ * @brief Chien de garde des tâches : sans effet sur la plateforme native.
+ */
+#ifndef HAL_ESP_TASK_WDT_H
+#define HAL_ESP_TASK_WDT_H
+#include "freertos_hal.h"
+
+typedef int esp_err_t;
+#define ESP_OK 0
+
+inline esp_err_t esp_task_wdt_init(uint32_t, bool) { return ESP_OK; }
+inline esp_err_t esp_task_wdt_add(TaskHandle_t) { return ESP_OK; }
+inline esp_err_t esp_task_wdt_delete(TaskHandle_t) { return ESP_OK; }
+inline esp_err_t esp_task_wdt_reset() { return ESP_OK; }
+#endif
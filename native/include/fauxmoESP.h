@@ -0,0 +1,32 @@
+/**
+ * @file fauxmoESP.h
+ * @brief Emulation Alexa de la couche native : les commandes sont injectées
+ *        par halFauxmoSetState().
+ */
+#ifndef HAL_FAUXMOESP_H
+#define HAL_FAUXMOESP_H
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+typedef std::function<void(unsigned char, const char*, bool, unsigned char)> TSetStateCallback;
+
+class fauxmoESP {
+  std::vector<std::string> _devices;
+  TSetStateCallback _callback;
+public:
+  unsigned char addDevice(const char* name) { _devices.push_back(name); return _devices.size() - 1; }
+  void onSetState(TSetStateCallback callback) { _callback = callback; }
+  void createServer(bool) {}
+  void setPort(unsigned long) {}
+  void enable(bool) {}
+  void handle() {}
+  bool setState(unsigned char, bool, unsigned char) { return true; }
+  // Commande vocale simulée
+  void halSetState(unsigned char id, bool state, unsigned char value) {
+    if (_callback && id < _devices.size())
+      _callback(id, _devices[id].c_str(), state, value);
+  }
+};
+#endif
@@ -0,0 +1,94 @@
+/**
+ * @file freertos_hal.h
+ * @brief Sous-ensemble de l'API FreeRTOS pour la couche native.
+ *
+ * Un seul fil d'exécution : les tâches créées ne sont pas exécutées,
+ * les sémaphores et sections critiques sont sans effet.
+ * Les temporisateurs (xTimer...) sont simulés : leurs callbacks sont
+ * appelés par halRunTimers() depuis delay() et la boucle du programme natif.
+ * Un tick = 1 ms.
+ */
+#ifndef HAL_FREERTOS_H
+#define HAL_FREERTOS_H
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+
+#define pdFALSE 0
+#define pdTRUE  1
+#define pdPASS  1
+#define pdFAIL  0
+#define portMAX_DELAY 0xffffffffUL
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS 1
+#define configMAX_PRIORITIES 25
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+//---------------- Tâches ----------------
+typedef void (*TaskFunction_t)(void*);
+struct HalTask;
+typedef HalTask* TaskHandle_t;
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stack,
+                       void* parameters, UBaseType_t priority, TaskHandle_t* handle);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stack,
+                                   void* parameters, UBaseType_t priority,
+                                   TaskHandle_t* handle, BaseType_t core);
+TaskHandle_t xTaskGetHandle(const char* name);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+void vTaskDelete(TaskHandle_t task);
+void vTaskSuspend(TaskHandle_t task);
+void vTaskResume(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t period);
+TickType_t xTaskGetTickCount();
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+inline BaseType_t xPortGetCoreID() { return 1; }
+
+//---------------- Temporisateurs ----------------
+struct HalTimer;
+typedef HalTimer* TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t);
+
+TimerHandle_t xTimerCreate(const char* name, TickType_t period, UBaseType_t autoReload,
+                           void* id, TimerCallbackFunction_t callback);
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t blockTime);
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t blockTime);
+BaseType_t xTimerReset(TimerHandle_t timer, TickType_t blockTime);
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t blockTime);
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer);
+TickType_t xTimerGetExpiryTime(TimerHandle_t timer);
+TickType_t xTimerGetPeriod(TimerHandle_t timer);
+void* pvTimerGetTimerID(TimerHandle_t timer);
+const char* pcTimerGetName(TimerHandle_t timer);
+
+/**
+ * @brief Appelle les callbacks des temporisateurs arrivés à échéance
+ *        (ordre des échéances, comme la tâche de service FreeRTOS)
+ */
+void halRunTimers();
+
+/**
+ * @brief Echéance du prochain temporisateur actif
+ * @param expiry tick d'échéance
+ * @return true si un temporisateur est actif
+ */
+bool halNextTimerExpiry(TickType_t* expiry);
+
+//---------------- Sémaphores ----------------
+typedef void* SemaphoreHandle_t;
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex();
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
+inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t) { return pdTRUE; }
+
+//---------------- Sections critiques ----------------
+typedef struct { int owner; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux)  ((void)(mux))
+#endif
@@ -0,0 +1,33 @@
+/**
+ * @file hal_time.h
+ * @brief Horloges de la couche native.
+ *
+ * - halMicros() : temps écoulé depuis le démarrage (millis, micros, ticks FreeRTOS)
+ * - halEpoch()  : heure système en secondes (ESP32Time, time())
+ *
+ * En temps virtuel (simulateur) les deux horloges n'avancent que par
+ * halAdvance() et delay() ; les temporisateurs FreeRTOS arrivés à échéance
+ * sont exécutés à leur date exacte pendant l'avance.
+ */
+#ifndef HAL_TIME_H
+#define HAL_TIME_H
+#include <cstdint>
+#include <ctime>
+
+// Temps écoulé depuis le démarrage du programme en microsecondes
+uint64_t halMicros();
+
+// Heure système (secondes depuis 1970), initialisée à l'heure de l'hôte
+time_t halEpoch();
+void halSetEpoch(time_t epoch);
+
+// Temps virtuel : horloges figées, avancées par halAdvance()
+// L'activation remet millis() à 0 et conserve l'heure système
+void halSetVirtualTime(bool enable);
+bool halVirtualTime();
+void halAdvance(uint64_t us);
+
+// Pas de NTP sur la plateforme native : getLocalTime() retourne l'heure système
+void configTime(long gmtOffset, int daylightOffset, const char* server);
+bool getLocalTime(struct tm* info, uint32_t ms = 5000);
+#endif
@@ -0,0 +1,22 @@
+/**
+ * @file simulator.h
+ * @brief Simulateur en temps accéléré (plateforme native).
+ */
+#ifndef HAL_SIMULATOR_H
+#define HAL_SIMULATOR_H
+#include <ctime>
+
+struct SimOptions {
+  time_t begin;          ///< Début de la simulation (heure locale)
+  long days;             ///< Durée simulée en jours
+  const char* scenario;  ///< Fichier scénario (NULL : aucun événement)
+  const char* trace;     ///< Fichier trace (NULL : pas de trace)
+  bool traceMqtt;        ///< Enregistrer aussi les publications MQTT
+};
+
+/**
+ * @brief Exécute l'application sur une horloge virtuelle
+ * @return int code de sortie du programme
+ */
+int simulate(const SimOptions& options);
+#endif
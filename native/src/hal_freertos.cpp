@@ -0,0 +1,177 @@
+/**
+ * @file hal_freertos.cpp
+ * @brief Temporisateurs FreeRTOS simulés et tâches inertes.
+ */
+#include <Arduino.h>
+#include <string>
+#include <vector>
+
+struct HalTask {
+  std::string name;
+};
+
+struct HalTimer {
+  std::string name;
+  TickType_t period;
+  UBaseType_t autoReload;
+  void* id;
+  TimerCallbackFunction_t callback;
+  bool active;
+  TickType_t expiry;
+};
+
+static std::vector<HalTask*> tasks;
+static std::vector<HalTimer*> timers;
+static HalTask loopTask = {"loopTask"};
+static int mutexes;
+
+//---------------- Tâches ----------------
+BaseType_t xTaskCreate(TaskFunction_t, const char* name, uint32_t, void*, UBaseType_t, TaskHandle_t* handle) {
+  HalTask* task = new HalTask{name};
+  tasks.push_back(task);
+  if (handle)
+    *handle = task;
+  return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stack,
+                                   void* parameters, UBaseType_t priority,
+                                   TaskHandle_t* handle, BaseType_t) {
+  return xTaskCreate(code, name, stack, parameters, priority, handle);
+}
+
+TaskHandle_t xTaskGetHandle(const char* name) {
+  for (HalTask* task : tasks)
+    if (task->name == name)
+      return task;
+  return NULL;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  return &loopTask;
+}
+
+void vTaskDelete(TaskHandle_t) {
+}
+
+void vTaskSuspend(TaskHandle_t) {
+}
+
+void vTaskResume(TaskHandle_t) {
+}
+
+void vTaskDelay(TickType_t ticks) {
+  delay(ticks);
+}
+
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t period) {
+  *previousWake += period;
+  TickType_t now = xTaskGetTickCount();
+  if ((int32_t)(*previousWake - now) > 0)
+    delay(*previousWake - now);
+}
+
+TickType_t xTaskGetTickCount() {
+  return (TickType_t)(halMicros() / 1000);
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) {
+  return 4096;
+}
+
+//---------------- Temporisateurs ----------------
+TimerHandle_t xTimerCreate(const char* name, TickType_t period, UBaseType_t autoReload,
+                           void* id, TimerCallbackFunction_t callback) {
+  HalTimer* timer = new HalTimer{name ? name : "", period, autoReload, id, callback, false, 0};
+  timers.push_back(timer);
+  return timer;
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t) {
+  timer->active = true;
+  timer->expiry = xTaskGetTickCount() + timer->period;
+  return pdPASS;
+}
+
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t) {
+  timer->active = false;
+  return pdPASS;
+}
+
+BaseType_t xTimerReset(TimerHandle_t timer, TickType_t blockTime) {
+  return xTimerStart(timer, blockTime);
+}
+
+// Comme FreeRTOS : le changement de période démarre le temporisateur
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t blockTime) {
+  timer->period = period;
+  return xTimerStart(timer, blockTime);
+}
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer) {
+  return timer->active ? pdTRUE : pdFALSE;
+}
+
+TickType_t xTimerGetExpiryTime(TimerHandle_t timer) {
+  return timer->expiry;
+}
+
+TickType_t xTimerGetPeriod(TimerHandle_t timer) {
+  return timer->period;
+}
+
+void* pvTimerGetTimerID(TimerHandle_t timer) {
+  return timer->id;
+}
+
+const char* pcTimerGetName(TimerHandle_t timer) {
+  return timer->name.c_str();
+}
+
+bool halNextTimerExpiry(TickType_t* expiry) {
+  bool found = false;
+  for (HalTimer* timer : timers) {
+    if (timer->active && (!found || (int32_t)(timer->expiry - *expiry) < 0)) {
+      *expiry = timer->expiry;
+      found = true;
+    }
+  }
+  return found;
+}
+
+void halRunTimers() {
+  // Comme la tâche de service : pas de réentrance si un callback appelle delay()
+  static bool running;
+  if (running)
+    return;
+  running = true;
+  // Remis à false même si un callback appelle ESP.restart() (exception HalRestart)
+  struct Release { bool& flag; ~Release() { flag = false; } } release{running};
+  // Un callback peut relancer ou arrêter d'autres temporisateurs :
+  // rechercher l'échéance la plus proche à chaque itération
+  for (;;) {
+    TickType_t now = xTaskGetTickCount();
+    HalTimer* next = NULL;
+    for (HalTimer* timer : timers) {
+      if (timer->active && (int32_t)(now - timer->expiry) >= 0 &&
+          (next == NULL || (int32_t)(timer->expiry - next->expiry) < 0))
+        next = timer;
+    }
+    if (next == NULL)
+      break;
+    if (next->autoReload)
+      next->expiry += next->period ? next->period : 1;
+    else
+      next->active = false;
+    next->callback(next);
+  }
+}
+
+//---------------- Sémaphores ----------------
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  return &++mutexes;
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+  return xSemaphoreCreateMutex();
+}
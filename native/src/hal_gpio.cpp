@@ -0,0 +1,96 @@
+/**
+ * @file hal_gpio.cpp
+ * @brief Broches simulées de la couche native.
+ */
+#include <Arduino.h>
+
+#define HAL_N_PINS 40
+
+static uint8_t pinModes[HAL_N_PINS];
+static uint8_t pinLevels[HAL_N_PINS];
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < HAL_N_PINS) {
+    pinModes[pin] = mode;
+    if (mode == INPUT_PULLUP)
+      pinLevels[pin] = HIGH;
+  }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin < HAL_N_PINS)
+    pinLevels[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+  return pin < HAL_N_PINS ? pinLevels[pin] : LOW;
+}
+
+int analogRead(uint8_t pin) {
+  return digitalRead(pin) ? 4095 : 0;
+}
+
+void halSetPin(uint8_t pin, int val) {
+  digitalWrite(pin, val);
+}
+
+void attachInterrupt(uint8_t, void (*)(), int) {
+}
+
+uint8_t digitalPinToInterrupt(uint8_t pin) {
+  return pin;
+}
+
+long random(long max) {
+  return max > 0 ? rand() % max : 0;
+}
+
+long random(long min, long max) {
+  return max > min ? min + rand() % (max - min) : min;
+}
+
+void randomSeed(unsigned long seed) {
+  srand(seed);
+}
+
+static char* toBase(unsigned long value, bool negative, char* buffer, int base) {
+  char digits[34];
+  int n = 0;
+  do {
+    int d = value % base;
+    digits[n++] = d < 10 ? '0' + d : 'a' + d - 10;
+    value /= base;
+  } while (value);
+  char* p = buffer;
+  if (negative)
+    *p++ = '-';
+  while (n)
+    *p++ = digits[--n];
+  *p = 0;
+  return buffer;
+}
+
+#if !defined(__GLIBC__) || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38)
+size_t strlcpy(char* dst, const char* src, size_t size) {
+  size_t length = strlen(src);
+  if (size > 0) {
+    size_t n = length < size - 1 ? length : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return length;
+}
+#endif
+
+char* itoa(int value, char* buffer, int base) {
+  return ltoa(value, buffer, base);
+}
+
+char* utoa(unsigned value, char* buffer, int base) {
+  return toBase(value, false, buffer, base);
+}
+
+char* ltoa(long value, char* buffer, int base) {
+  bool negative = value < 0 && base == 10;
+  return toBase(negative ? -(unsigned long)value : (unsigned long)value, negative, buffer, base);
+}
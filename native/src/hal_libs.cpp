@@ -0,0 +1,204 @@
+/**
+ * @file hal_libs.cpp
+ * @brief Instances et implémentation des bibliothèques simulées
+ *        (Serial, ESP, WiFi, OTA, I2C, LittleFS, PubSubClient).
+ */
+#include <Arduino.h>
+#include <ArduinoOTA.h>
+#include <LittleFS.h>
+#include <PubSubClient.h>
+#include <Wire.h>
+
+HardwareSerial Serial;
+EspClass ESP;
+WiFiClass WiFi;
+ArduinoOTAClass ArduinoOTA;
+TwoWire Wire;
+LittleFSFS LittleFS;
+
+static esp_reset_reason_t resetReason = ESP_RST_POWERON;
+
+void EspClass::restart() {
+  fflush(stdout);
+  resetReason = ESP_RST_SW;
+  throw HalRestart();
+}
+
+esp_reset_reason_t esp_reset_reason() {
+  return resetReason;
+}
+
+void halSetResetReason(esp_reset_reason_t reason) {
+  resetReason = reason;
+}
+
+//---------------- LittleFS ----------------
+File::File(std::shared_ptr<std::string> data, const char* path, const char* mode)
+  : _data(data), _path(path) {
+  _write = mode[0] == 'w' || mode[0] == 'a';
+  _position = mode[0] == 'a' ? data->size() : 0;
+}
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+  if (!_data || !_write)
+    return 0;
+  _data->replace(_position, std::min(size, _data->size() - _position), (const char*)buffer, size);
+  _position += size;
+  return size;
+}
+
+int File::read() {
+  return available() ? (uint8_t)(*_data)[_position++] : -1;
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+  size_t n = std::min(size, (size_t)available());
+  if (n)
+    memcpy(buffer, _data->data() + _position, n);
+  _position += n;
+  return n;
+}
+
+String File::readString() {
+  if (!_data)
+    return String();
+  String s(_data->substr(_position));
+  _position = _data->size();
+  return s;
+}
+
+String File::readStringUntil(char terminator) {
+  if (!_data)
+    return String();
+  size_t end = _data->find(terminator, _position);
+  if (end == std::string::npos)
+    end = _data->size();
+  String s(_data->substr(_position, end - _position));
+  _position = std::min(end + 1, _data->size());
+  return s;
+}
+
+bool File::seek(uint32_t position, SeekMode mode) {
+  if (!_data)
+    return false;
+  size_t base = mode == SeekSet ? 0 : mode == SeekCur ? _position : _data->size();
+  if (base + position > _data->size())
+    return false;
+  _position = base + position;
+  return true;
+}
+
+const char* File::name() const {
+  size_t slash = _path.rfind('/');
+  return _path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+}
+
+File LittleFSFS::open(const char* path, const char* mode, bool) {
+  auto it = _files.find(path);
+  if (mode[0] == 'r')
+    return it == _files.end() ? File() : File(it->second, path, mode);
+  if (it == _files.end())
+    it = _files.emplace(path, std::make_shared<std::string>()).first;
+  else if (mode[0] == 'w')
+    it->second->clear();
+  return File(it->second, path, mode);
+}
+
+bool LittleFSFS::rename(const char* from, const char* to) {
+  auto it = _files.find(from);
+  if (it == _files.end())
+    return false;
+  _files[to] = it->second;
+  _files.erase(it);
+  return true;
+}
+
+std::map<std::string, std::string> LittleFSFS::halFiles() {
+  std::map<std::string, std::string> files;
+  for (auto& file : _files)
+    files[file.first] = *file.second;
+  return files;
+}
+
+void LittleFSFS::halSetFiles(const std::map<std::string, std::string>& files) {
+  _files.clear();
+  for (auto& file : files)
+    _files[file.first] = std::make_shared<std::string>(file.second);
+}
+
+size_t LittleFSFS::usedBytes() {
+  size_t used = 0;
+  for (auto& file : _files)
+    used += file.second->size();
+  return used;
+}
+
+//---------------- PubSubClient ----------------
+void (*halMqttOnPublish)(const char* topic, const char* payload);
+
+static std::deque<std::pair<std::string, std::string>> mqttInbox;
+
+void halMqttInject(const char* topic, const char* payload) {
+  mqttInbox.emplace_back(topic, payload);
+}
+
+bool PubSubClient::subscribed(const std::string& topic) const {
+  for (const std::string& filter : _subscriptions) {
+    if (filter == topic)
+      return true;
+    if (!filter.empty() && filter.back() == '#' &&
+        topic.compare(0, filter.size() - 1, filter, 0, filter.size() - 1) == 0)
+      return true;
+  }
+  return false;
+}
+
+bool PubSubClient::publish(const char* topic, const char* payload) {
+  if (!connected())
+    return false;
+  if (halMqttOnPublish)
+    halMqttOnPublish(topic, payload);
+  return true;
+}
+
+bool PubSubClient::publish(const char* topic, const char* payload, bool) {
+  return publish(topic, payload);
+}
+
+bool PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned int length, bool) {
+  std::string s((const char*)payload, length);
+  return publish(topic, s.c_str());
+}
+
+bool PubSubClient::subscribe(const char* topic, uint8_t) {
+  if (!subscribed(topic))
+    _subscriptions.push_back(topic);
+  return _connected;
+}
+
+bool PubSubClient::unsubscribe(const char* topic) {
+  for (auto it = _subscriptions.begin(); it != _subscriptions.end(); ++it)
+    if (*it == topic) {
+      _subscriptions.erase(it);
+      return true;
+    }
+  return false;
+}
+
+bool PubSubClient::loop() {
+  if (!connected())
+    return false;
+  // Un message par appel, comme la lecture d'un paquet par le client réel
+  if (!mqttInbox.empty()) {
+    std::pair<std::string, std::string> message = mqttInbox.front();
+    mqttInbox.pop_front();
+    if (callback && subscribed(message.first)) {
+      std::vector<char> topic(message.first.begin(), message.first.end());
+      topic.push_back(0);
+      std::vector<uint8_t> payload(message.second.begin(), message.second.end());
+      payload.push_back(0);
+      callback(topic.data(), payload.data(), message.second.size());
+    }
+  }
+  return true;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file hal_time.cpp
+ * @brief Horloges de la couche native : temps réel de l'hôte ou temps virtuel.
+ */
+#include <Arduino.h>
+#include <chrono>
+#include <thread>
+
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+// Ecart entre l'heure système simulée et l'heure de l'hôte
+static time_t epochOffset;
+
+// Temps virtuel
+static bool virtualTime;
+static uint64_t virtualMicros;
+static time_t virtualEpoch;  // Heure système à virtualMicros = 0
+
+uint64_t halMicros() {
+  if (virtualTime)
+    return virtualMicros;
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - bootTime).count();
+}
+
+time_t halEpoch() {
+  if (virtualTime)
+    return virtualEpoch + virtualMicros / 1000000;
+  return time(NULL) + epochOffset;
+}
+
+void halSetEpoch(time_t epoch) {
+  if (virtualTime)
+    virtualEpoch = epoch - virtualMicros / 1000000;
+  else
+    epochOffset = epoch - time(NULL);
+}
+
+void halSetVirtualTime(bool enable) {
+  // Démarrage de l'horloge virtuelle : millis() repart de 0, l'heure système est conservée
+  if (enable && !virtualTime) {
+    virtualEpoch = halEpoch();
+    virtualMicros = 0;
+  }
+  virtualTime = enable;
+}
+
+bool halVirtualTime() {
+  return virtualTime;
+}
+
+void halAdvance(uint64_t us) {
+  uint64_t target = virtualMicros + us;
+  TickType_t expiry;
+  // Exécuter chaque temporisateur à son échéance exacte
+  while (halNextTimerExpiry(&expiry)) {
+    int32_t ticks = (int32_t)(expiry - xTaskGetTickCount());
+    uint64_t at = (virtualMicros / 1000 + (ticks > 0 ? ticks : 0)) * 1000;
+    if (at > target)
+      break;
+    if (at > virtualMicros)
+      virtualMicros = at;
+    halRunTimers();
+  }
+  virtualMicros = target;
+}
+
+void configTime(long, int, const char*) {
+}
+
+bool getLocalTime(struct tm* info, uint32_t) {
+  time_t t = halEpoch();
+  gmtime_r(&t, info);
+  return true;
+}
+
+void delay(unsigned long ms) {
+  if (virtualTime) {
+    halAdvance(ms * 1000ULL);
+    return;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+  halRunTimers();
+}
+
+void yield() {
+  halRunTimers();
+}
+
+void delayMicroseconds(unsigned int us) {
+  if (virtualTime) {
+    virtualMicros += us;
+    return;
+  }
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
@@ -0,0 +1,90 @@
+/**
+ * @file main_native.cpp
+ * @brief Point d'entrée de la plateforme native.
+ *
+ * Sans option -d : équivalent de la tâche loopTask du framework Arduino ESP32,
+ * setup() puis loop() en temps réel, les temporisateurs FreeRTOS simulés sont
+ * exécutés entre deux itérations. ESP.restart() relance setup().
+ *
+ * Avec -d : simulateur en temps accéléré (simulator.h).
+ *
+ * Options :
+ *   -n <itérations>  nombre d'appels à loop() avant de terminer (défaut : infini)
+ *   -d <jours>       durée simulée
+ *   -b <date>        début de la simulation "AAAA-MM-JJ HH:MM" (défaut : 1er janvier 00:00)
+ *   -s <fichier>     scénario (entrées, messages MQTT, commandes Alexa)
+ *   -t <fichier>     trace des commutations de relais
+ *   -m               trace aussi les publications MQTT
+ *
+ * Non compilé pour les tests (pio test -e native) : chaque test a son main().
+ */
+#include <Arduino.h>
+#include <unistd.h>
+#include "simulator.h"
+
+#ifndef PIO_UNIT_TESTING
+
+static void usage(const char* name) {
+  fprintf(stderr, "usage : %s [-n iterations] | -d jours [-b \"AAAA-MM-JJ HH:MM\"] "
+                  "[-s scenario] [-t trace] [-m]\n", name);
+}
+
+int main(int argc, char** argv) {
+  unsigned long iterations = 0;
+  SimOptions options = {};
+  struct tm begin = {};
+  begin.tm_year = 2026 - 1900;
+  begin.tm_mday = 1;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:d:b:s:t:m")) != -1) {
+    switch (opt) {
+    case 'n':
+      iterations = strtoul(optarg, NULL, 10);
+      break;
+    case 'd':
+      options.days = strtol(optarg, NULL, 10);
+      break;
+    case 'b':
+      begin = {};
+      if (sscanf(optarg, "%d-%d-%d %d:%d", &begin.tm_year, &begin.tm_mon, &begin.tm_mday,
+                 &begin.tm_hour, &begin.tm_min) < 3) {
+        usage(argv[0]);
+        return 1;
+      }
+      begin.tm_year -= 1900;
+      begin.tm_mon -= 1;
+      break;
+    case 's':
+      options.scenario = optarg;
+      break;
+    case 't':
+      options.trace = optarg;
+      break;
+    case 'm':
+      options.traceMqtt = true;
+      break;
+    default:
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  setvbuf(stdout, NULL, _IOLBF, 0);
+  if (options.days > 0) {
+    options.begin = timegm(&begin);
+    return simulate(options);
+  }
+  for (;;) {
+    try {
+      setup();
+      for (unsigned long i = 0; iterations == 0 || i < iterations; i++) {
+        loop();
+        halRunTimers();
+      }
+      return 0;
+    }
+    catch (const HalRestart&) {
+      printf("\n--- ESP.restart() ---\n");
+    }
+  }
+}
+#endif
@@ -0,0 +1,445 @@
+/**
+ * @file simulator.cpp
+ * @brief Simulateur en temps accéléré de l'automate (plateforme native).
+ *
+ * L'application complète (setup/loop) tourne sur une horloge virtuelle :
+ * - les temporisateurs FreeRTOS sont exécutés à leur échéance exacte,
+ * - les entrées (télécommande, contact surpresseur, porte armoire), les
+ *   messages MQTT et les commandes Alexa proviennent d'un fichier scénario,
+ * - chaque commutation de relais est enregistrée dans un fichier trace.
+ *
+ * Pour simuler une année en quelques secondes, l'horloge avance par pas de
+ * 10 ms pendant SIM_ACTIVE_WINDOW après une activité (entrée, relais, message),
+ * puis directement jusqu'à la minute suivante, au prochain temporisateur ou au
+ * prochain événement du scénario.
+ *
+ * Chaque démarrage (mise sous tension, ESP.restart()) s'exécute dans un
+ * processus fils créé à partir du processus principal qui n'a jamais exécuté
+ * setup() : toutes les variables (globales, statiques) repartent de leur état
+ * initial comme sur l'ESP32. Seuls sont transmis au démarrage suivant la
+ * mémoire flash (LittleFS), les variables RTC_NOINIT_ATTR, l'heure système
+ * et l'état du simulateur. millis() repart de 0, l'heure système est arrondie
+ * à la seconde supérieure (durée du redémarrage).
+ *
+ * Scénario : une ligne par événement, heure locale (heure d'été SUMMER_TIME
+ * appliquée comme ESP32Time), lignes vides et commentaires '#' ignorés :
+ *   2026-06-01 06:30:00 input arrosage 1        # contact fermé (0 : ouvert)
+ *   2026-06-01 06:30:00 press irrigation        # appui bref sur la télécommande
+ *   2026-06-01 07:00:00 mqtt homecontrol/vmc 2  # message reçu du courtier
+ *   2026-06-01 08:00:00 alexa 1 1 255           # commande vocale (id, état, valeur)
+ *   2026-06-01 09:00:00 wifi 0                  # perte (0) ou retour (1) du WiFi
+ * Entrées : arrosage, irrigation, surpresseur, porte.
+ *
+ * Trace (CSV) : date locale;type;nom;valeur
+ *   relay : commutation d'un relais (1 = relais alimenté)
+ *   mqtt  : publication du client (option -m)
+ *   restart : ESP.restart()
+ */
+#include <Arduino.h>
+#include <PubSubClient.h>
+#include <fauxmoESP.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+#include <LittleFS.h>
+#include "const.h"
+#include "io.h"
+#include "simple_param.h"
+#include "simulator.h"
+
+// Durée des pas fins après une activité
+#define SIM_FINE_STEP_US (INTERVAL_ROTATARY_SCHEDULE * 1000ULL)
+// Durée de la fenêtre d'activité (us)
+#define SIM_ACTIVE_WINDOW (5 * 1000000ULL)
+// Durée d'un appui bref (press)
+#define SIM_PRESS_MS 300
+
+extern SimpleParam* cDlyParam;
+#ifdef ALEXA
+extern fauxmoESP fauxmo;
+#endif
+
+struct SimEvent {
+  time_t time;          // Heure locale (secondes)
+  std::string command;
+  std::string name;
+  std::string value;
+};
+
+static const char* const relayNames[8] = {
+  "VMC", "PAC", "FOUR", "POMPE", "TRANSFO", "EV_ARROSAGE", "EV_IRRIGATION", "EV_EST"
+};
+
+// Variables RTC_NOINIT_ATTR (section rtc_noinit, symboles fournis par l'éditeur de liens)
+extern char __start_rtc_noinit[] __attribute__((weak));
+extern char __stop_rtc_noinit[] __attribute__((weak));
+
+/**
+ * @brief Etat conservé d'un démarrage à l'autre
+ */
+struct SimState {
+  uint64_t epochUs;             // Heure système (us)
+  time_t end;                   // Fin de la simulation (heure système)
+  size_t next;                  // Prochain événement du scénario
+  unsigned closedInputs;        // Contacts fermés
+  unsigned outputs;             // Relais lors de la dernière trace
+  unsigned long iterations;
+  unsigned long transitions;
+  unsigned long publications;
+  unsigned long restarts;
+  bool finished;
+};
+
+static SimState state;
+static std::map<std::string, std::string> flash;
+static std::string rtcMemory;
+
+static FILE* trace;
+static bool traceMqtt;
+static uint64_t lastActivity;
+
+/**
+ * @brief Décalage heure locale (heure d'été) appliqué par ESP32Time
+ */
+static long localOffset() {
+  return cDlyParam ? cDlyParam->get(SUMMER_TIME) * 3600L : 0;
+}
+
+static void traceLine(const char* type, const char* name, const char* value) {
+  if (trace == NULL)
+    return;
+  time_t t = halEpoch() + localOffset();
+  struct tm info;
+  gmtime_r(&t, &info);
+  char date[32];
+  strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &info);
+  fprintf(trace, "%s.%03u;%s;%s;%s\n", date, (unsigned)(halMicros() / 1000 % 1000), type, name, value);
+}
+
+static void onPublish(const char* topic, const char* payload) {
+  state.publications++;
+  if (traceMqtt)
+    traceLine("mqtt", topic, payload);
+}
+
+/**
+ * @brief Enregistre les relais qui ont commuté depuis l'appel précédent
+ */
+static void traceOutputs() {
+  // Ecriture des registres par le cycle de scrutation suivant
+  // (au plus INTERVAL_IO_SCRUT plus tard sur la cible)
+  ioFlush();
+  unsigned outputs = ioMockOutputs() >> 16;
+  unsigned changed = outputs ^ state.outputs;
+  if (changed == 0)
+    return;
+  for (int bit = 0; bit < 8; bit++)
+    if (changed & (1 << bit)) {
+      traceLine("relay", relayNames[bit], outputs & (1 << bit) ? "1" : "0");
+      state.transitions++;
+    }
+  state.outputs = outputs;
+  lastActivity = halMicros();
+}
+
+static bool parseDate(const char* text, time_t* t) {
+  struct tm info = {};
+  if (sscanf(text, "%d-%d-%d %d:%d:%d", &info.tm_year, &info.tm_mon, &info.tm_mday,
+             &info.tm_hour, &info.tm_min, &info.tm_sec) < 5)
+    return false;
+  info.tm_year -= 1900;
+  info.tm_mon -= 1;
+  *t = timegm(&info);
+  return true;
+}
+
+static bool loadScenario(const char* path, std::vector<SimEvent>& events) {
+  std::ifstream file(path);
+  if (!file) {
+    fprintf(stderr, "Scénario %s introuvable\n", path);
+    return false;
+  }
+  std::string line;
+  int n = 0;
+  while (std::getline(file, line)) {
+    n++;
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    // Commentaire en fin de ligne
+    size_t comment = line.find(" #");
+    if (comment != std::string::npos)
+      line.erase(line.find_last_not_of(" \t", comment) + 1);
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream in(line);
+    std::string day, hour;
+    SimEvent event;
+    in >> day >> hour >> event.command >> event.name;
+    std::getline(in >> std::ws, event.value);
+    if (!parseDate((day + " " + hour).c_str(), &event.time) || event.command.empty()) {
+      fprintf(stderr, "%s:%d : ligne invalide\n", path, n);
+      return false;
+    }
+    events.push_back(event);
+  }
+  // Ordre chronologique, ordre du fichier pour une même seconde
+  std::stable_sort(events.begin(), events.end(),
+    [](const SimEvent& a, const SimEvent& b) { return a.time < b.time; });
+  return true;
+}
+
+static unsigned inputMask(const std::string& name) {
+  if (name == "arrosage")    return I_ARROSAGE;
+  if (name == "irrigation")  return I_IRRIGATION;
+  if (name == "surpresseur") return I_SURPRESSEUR;
+  if (name == "porte")       return I_LCD_CMD;
+  return 0;
+}
+
+static void setInput(unsigned mask, bool closed) {
+  state.closedInputs = closed ? state.closedInputs | mask : state.closedInputs & ~mask;
+  ioMockSetInputs(state.closedInputs);
+}
+
+static void applyEvent(const SimEvent& event) {
+  lastActivity = halMicros();
+  if (event.command == "input" || event.command == "press") {
+    unsigned mask = inputMask(event.name);
+    if (mask == 0) {
+      fprintf(stderr, "Entrée inconnue : %s\n", event.name.c_str());
+      return;
+    }
+    traceLine("input", event.name.c_str(), event.command == "press" ? "press" : event.value.c_str());
+    if (event.command == "input") {
+      setInput(mask, atoi(event.value.c_str()) != 0);
+      return;
+    }
+    // Appui bref : laisser plusieurs cycles de scrutation voir le contact fermé
+    setInput(mask, true);
+    for (uint64_t end = halMicros() + SIM_PRESS_MS * 1000ULL; halMicros() < end; ) {
+      loop();
+      halAdvance(SIM_FINE_STEP_US);
+      traceOutputs();
+    }
+    setInput(mask, false);
+  }
+  else if (event.command == "mqtt") {
+    traceLine("mqtt_in", event.name.c_str(), event.value.c_str());
+    halMqttInject(event.name.c_str(), event.value.c_str());
+  }
+#ifdef ALEXA
+  else if (event.command == "alexa") {
+    int state = 0, value = 0;
+    sscanf(event.value.c_str(), "%d %d", &state, &value);
+    traceLine("alexa", event.name.c_str(), event.value.c_str());
+    fauxmo.halSetState(atoi(event.name.c_str()), state != 0, value);
+  }
+#endif
+  else if (event.command == "wifi") {
+    traceLine("wifi", "", event.name.c_str());
+    WiFi.halSetConnected(atoi(event.name.c_str()) != 0);
+  }
+  else
+    fprintf(stderr, "Commande inconnue : %s\n", event.command.c_str());
+}
+
+/**
+ * @brief Sauvegarde de l'état au moment de l'arrêt (ESP.restart() ou fin de simulation)
+ */
+static void saveState() {
+  state.epochUs = (uint64_t)halEpoch() * 1000000ULL + halMicros() % 1000000ULL;
+  flash = LittleFS.halFiles();
+  rtcMemory.assign(__start_rtc_noinit, __stop_rtc_noinit - __start_rtc_noinit);
+}
+
+static bool writeAll(int fd, const void* data, size_t size) {
+  for (const char* p = (const char*)data; size > 0; ) {
+    ssize_t n = write(fd, p, size);
+    if (n <= 0)
+      return false;
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+static bool readAll(int fd, void* data, size_t size) {
+  for (char* p = (char*)data; size > 0; ) {
+    ssize_t n = read(fd, p, size);
+    if (n <= 0)
+      return false;
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+static bool writeString(int fd, const std::string& text) {
+  size_t size = text.size();
+  return writeAll(fd, &size, sizeof(size)) && writeAll(fd, text.data(), size);
+}
+
+static bool readString(int fd, std::string& text) {
+  size_t size;
+  if (!readAll(fd, &size, sizeof(size)))
+    return false;
+  text.resize(size);
+  return readAll(fd, &text[0], size);
+}
+
+/**
+ * @brief Transmission de l'état du processus fils au processus principal
+ */
+static bool sendState(int fd) {
+  size_t n = flash.size();
+  if (!writeAll(fd, &state, sizeof(state)) || !writeString(fd, rtcMemory) ||
+      !writeAll(fd, &n, sizeof(n)))
+    return false;
+  for (auto& file : flash)
+    if (!writeString(fd, file.first) || !writeString(fd, file.second))
+      return false;
+  return true;
+}
+
+static bool receiveState(int fd) {
+  size_t n;
+  if (!readAll(fd, &state, sizeof(state)) || !readString(fd, rtcMemory) ||
+      !readAll(fd, &n, sizeof(n)))
+    return false;
+  flash.clear();
+  while (n-- > 0) {
+    std::string name, data;
+    if (!readString(fd, name) || !readString(fd, data))
+      return false;
+    flash[name] = data;
+  }
+  return true;
+}
+
+/**
+ * @brief Un démarrage de l'automate : setup() puis loop() jusqu'à ESP.restart()
+ *        ou la fin de la simulation
+ */
+static void run(const std::vector<SimEvent>& events, time_t begin, long days) {
+  halMqttOnPublish = onPublish;
+  halSetVirtualTime(true);
+  if (state.restarts == 0) {
+    halSetEpoch(begin);
+  }
+  else {
+    halSetEpoch((time_t)((state.epochUs + 999999ULL) / 1000000ULL));
+    LittleFS.halSetFiles(flash);
+    if (rtcMemory.size() == (size_t)(__stop_rtc_noinit - __start_rtc_noinit))
+      memcpy(__start_rtc_noinit, rtcMemory.data(), rtcMemory.size());
+    halSetResetReason(ESP_RST_SW);
+  }
+  ioMockSetInputs(state.closedInputs);
+
+  try {
+    setup();
+    if (state.restarts == 0) {
+      // Heure locale connue après lecture des paramètres : recaler le début
+      halSetEpoch(begin - localOffset());
+      state.end = halEpoch() + days * 24 * 3600L;
+    }
+    while (halEpoch() < state.end) {
+      while (state.next < events.size() && events[state.next].time <= halEpoch() + localOffset())
+        applyEvent(events[state.next++]);
+      loop();
+      state.iterations++;
+      halRunTimers();
+      traceOutputs();
+
+      uint64_t now = halMicros();
+      uint64_t step;
+      if (now - lastActivity < SIM_ACTIVE_WINDOW) {
+        step = SIM_FINE_STEP_US;
+      }
+      else {
+        // Minute suivante (+ INTERVAL_SCHEDULE pour que loop() voie le changement)
+        uint64_t usInMinute = (uint64_t)(halEpoch() % 60) * 1000000ULL + now % 1000000ULL;
+        step = 60 * 1000000ULL - usInMinute + INTERVAL_SCHEDULE * 1000ULL;
+        // Prochain événement du scénario
+        if (state.next < events.size()) {
+          time_t t = events[state.next].time - localOffset();
+          uint64_t until = t > halEpoch() ? (uint64_t)(t - halEpoch()) * 1000000ULL : 0;
+          step = std::min<uint64_t>(step, until > 0 ? until : SIM_FINE_STEP_US);
+        }
+        // Prochain temporisateur : loop() doit tourner juste après son callback
+        TickType_t expiry;
+        if (halNextTimerExpiry(&expiry)) {
+          int32_t ticks = (int32_t)(expiry - xTaskGetTickCount());
+          uint64_t until = (uint64_t)(ticks > 0 ? ticks + 1 : 1) * 1000;
+          step = std::min(step, until);
+        }
+      }
+      halAdvance(step);
+      traceOutputs();
+    }
+    state.finished = true;
+  }
+  catch (const HalRestart&) {
+    traceLine("restart", "", "");
+    state.restarts++;
+  }
+  saveState();
+}
+
+int simulate(const SimOptions& options) {
+  std::vector<SimEvent> events;
+  if (options.scenario && !loadScenario(options.scenario, events))
+    return 1;
+  if (options.trace) {
+    trace = fopen(options.trace, "w");
+    if (trace == NULL) {
+      fprintf(stderr, "Trace %s : ouverture impossible\n", options.trace);
+      return 1;
+    }
+  }
+  traceMqtt = options.traceMqtt;
+
+  auto wallStart = std::chrono::steady_clock::now();
+  while (!state.finished) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+      perror("pipe");
+      return 1;
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+      perror("fork");
+      return 1;
+    }
+    if (pid == 0) {
+      close(fds[0]);
+      run(events, options.begin, options.days);
+      fflush(stdout);
+      if (trace)
+        fflush(trace);
+      _exit(sendState(fds[1]) ? 0 : 1);
+    }
+    close(fds[1]);
+    bool received = receiveState(fds[0]);
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    if (!received || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      fprintf(stderr, "Simulation interrompue (état %d)\n", status);
+      return 1;
+    }
+  }
+
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  printf("\nSimulation : %ld jour(s), %lu redémarrage(s), %lu itérations de loop(), "
+         "%lu commutations, %lu publications MQTT, %.2f s\n",
+         options.days, state.restarts, state.iterations, state.transitions,
+         state.publications, wall);
+  if (trace)
+    fclose(trace);
+  return 0;
+}
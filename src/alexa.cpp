@@ -17,11 +17,11 @@ void initAlexa() {
 void cuisine() {
   if (_state) {
     on(O_FOUR);
-    mqttClient.publish(TOPIC_STATUS_CUISINE, "on");
+    mqttPublish(TOPIC_STATUS_CUISINE, "on");
     return;
   }
   off(O_FOUR);
-  mqttClient.publish(TOPIC_STATUS_CUISINE, "off");
+  mqttPublish(TOPIC_STATUS_CUISINE, "off");
 }
 
 void vmc() {
@@ -59,7 +59,7 @@ void clim() {
     #endif
   }
   else {
-      mqttClient.publish(TOPIC_PAC_IR_OFF, "");
+      mqttPublish(TOPIC_PAC_IR_OFF, "");
       // Couper alim PAC après DLY_OFF secondes
       t_start(tache_t_monoPacOff); // Logique inversée pour relai PAC
       t_stop(tache_t_monoPacOn);
@@ -69,7 +69,7 @@ void clim() {
 #endif
   } 
   #ifdef PERSISTANT_PAC
-    filePersistantParam->writeFile(cPersistantParam->getStr(), "w");
+    persistParam(filePersistantParam, cPersistantParam);
   #endif
 }
 
@@ -7,6 +7,7 @@
  * 
  * @details
  * - initDisplay: Initializes the display and creates custom characters.
+ * - lcdLock/lcdUnlock: Serialise LCD access between loop(), the scan task and timers.
  * - lcdClear: Clears the display.
  * - backLightOn: Turns on the backlight with a timer.
  * - backLightOff: Turns off the backlight.
@@ -42,7 +43,20 @@ byte rssi_char[8] = {
 
 extern char rssi_buffer[10];
 
+static SemaphoreHandle_t lcdMutex;
+
+void lcdLock() {
+  if (lcdMutex)
+    xSemaphoreTakeRecursive(lcdMutex, portMAX_DELAY);
+}
+
+void lcdUnlock() {
+  if (lcdMutex)
+    xSemaphoreGiveRecursive(lcdMutex);
+}
+
 void initDisplay() {
+  lcdMutex = xSemaphoreCreateRecursiveMutex();
   Wire.begin(I2C_SDA, I2C_SCL);
   // initialize LCD
   lcd.createChar(0, rssi_char);   
@@ -50,6 +64,7 @@ void initDisplay() {
 }
 
 void lcdClear() {
+  LcdGuard guard;
   lcd.clear();
 }
 /**
@@ -57,6 +72,7 @@ void lcdClear() {
  * 
  */
 void backLightOn() {
+  LcdGuard guard;
   isLcdDisplayOn = true;
   lcd.displayOn(); // displayOn set backLight
   t_start(tache_t_backLight);
@@ -67,6 +83,7 @@ void backLightOn() {
  */
 void backLightOff() {
 #ifndef FORCE_DISPLAY
+  LcdGuard guard;
   isLcdDisplayOn = false;
   lcd.displayOff(); // dispplayOn set noBacklight
 #endif  
@@ -80,6 +97,7 @@ void backLightOff() {
  * @param clearLine true = ligne effcée au préalable
  */
 void lcdPrintString(const char* text, int l, int c, boolean clearLine) {
+  LcdGuard guard;
   if (bootDisplayOff)
       lcd.displayOff();
   if (clearLine) {
@@ -97,6 +115,7 @@ void lcdPrintString(const char* text, int l, int c, boolean clearLine) {
  * @param c colonne
  */
 void lcdPrintChar(char ch, int l, int c) {
+  LcdGuard guard;
   lcd.setCursor(c, l);
   lcd.print(ch);
 }
@@ -105,6 +124,7 @@ void lcdPrintChar(char ch, int l, int c) {
  * @param rssi_buffer 
  */
 void lcdPrintRssi(char *rssi_buffer) {
+  LcdGuard guard;
   lcd.setCursor(RSSI_COLUMS_POS, RSSI_ROWS_POS);
   lcd.print(rssi_buffer);
   lcd.setCursor(RSSI_COLUMS_POS-1, RSSI_ROWS_POS);
@@ -126,6 +146,8 @@ void ioDisplay() {
  * @param msg message signalant la commande disponible 
  */
 void displayPrint1(const char* output, const char* input, const char* msg) {
+  // Ecran complet sans affichage intercalé d'une autre tâche
+  LcdGuard guard;
   lcd.clear();
   backLightOn();
   // t_start(tache_t_backLight);
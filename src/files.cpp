@@ -4,20 +4,80 @@
 #include <Arduino.h>
 #ifndef  __FILE_H
 #include "files.h"
+#include "profile.h"
+#include "flash_stats.h"
 
 #define FORMAT_LITTLEFS_IF_FAILED true
+// "HC"
+#define RECORD_MAGIC 0x4843
+
+static boolean mounted;
+// Descripteurs d'ajout partagés entre loop(), la tâche de scrutation et les temporisateurs
+static SemaphoreHandle_t fsMutex;
+
+FileLittleFS* FileLittleFS::appendFiles;
+
+/**
+ * @brief Verrou de portée sur les descripteurs d'ajout
+ */
+class FsGuard {
+public:
+  FsGuard() { if (fsMutex) xSemaphoreTakeRecursive(fsMutex, portMAX_DELAY); }
+  ~FsGuard() { if (fsMutex) xSemaphoreGiveRecursive(fsMutex); }
+};
+
+/**
+ * @brief Monte le système de fichiers (une seule fois)
+ * 
+ * @return true si le système de fichiers est monté
+ */
+boolean FileLittleFS::mount() {
+  if (!mounted) {
+    mounted = LittleFS_.begin(FORMAT_LITTLEFS_IF_FAILED);
+    if (!mounted)
+      Serial.println("LITTLEFS Mount Failed");
+    if (!fsMutex)
+      fsMutex = xSemaphoreCreateRecursiveMutex();
+  }
+  return mounted;
+}
+
 /**
  * @brief Construct a new File Little F S:: File Little F S object
  * 
  * @param name 
  */
 FileLittleFS::FileLittleFS(const char *name) {
-  if (!LittleFS_.begin(FORMAT_LITTLEFS_IF_FAILED)) {
-    Serial.println("LITTLEFS Mount Failed");
+  mount();
+  strncpy(path, name, sizeof(path) - 1);
+  path[sizeof(path) - 1] = '\0';
+  size = -1;
+  seq = 0;
+  seqKnown = false;
+  fromTemp = false;
+  nextAppend = NULL;
+}
+
+FileLittleFS::~FileLittleFS() {
+  closeAppend();
+}
+
+/**
+ * @brief Ferme le descripteur d'ajout (écriture des données en cache)
+ */
+void FileLittleFS::closeAppend() {
+  FsGuard guard;
+  if (!appendFile)
     return;
-  }
-  strcpy(path, name);
+  appendFile.close();
+  for (FileLittleFS** p = &appendFiles; *p; p = &(*p)->nextAppend)
+    if (*p == this) {
+      *p = nextAppend;
+      break;
+    }
+  nextAppend = NULL;
 }
+
 /**
  * @brief Ouvre un fichier existant
  * 
@@ -26,38 +86,250 @@ FileLittleFS::FileLittleFS(const char *name) {
  * @return false 
  */
 bool FileLittleFS::open(const char *mode) {
+  closeAppend();
+  size = -1;
   file = LittleFS_.open(F(path), mode);
   return file != 0;
 }
 /**
  * @brief Ecrit un fichier text
+ *        En ajout ("a"), une seule écriture dans le descripteur conservé ouvert.
  * 
  * @param message (char*) text à mémoriser
- * @param mode "w"
+ * @param mode "w" ou "a"
  * @return boolean 
  */
 boolean FileLittleFS::writeFile(const char *message, const char* mode) {
+  size_t length = strlen(message);
+  if (strcmp(mode, "a") == 0)
+    return append(message, length);
+  ProfTimer timer(PROF_FS_WRITE);
+  closeAppend();
   file = LittleFS_.open(F(path), mode);
-  if (!file.print(message)) {
+  boolean ok = file && file.print(message) == length;
+  file.close();
+  size = ok ? (long)length : -1;
+  if (!ok)
     Serial.println("Erreur ecriture");
+  flashAccountWrite(path, length);
+  return ok;
+}
+
+/**
+ * @brief Ajoute des données en fin de fichier
+ *        Une seule écriture dans le descripteur d'ajout conservé ouvert.
+ * 
+ * @param data données
+ * @param size taille des données
+ * @return boolean true si les données sont écrites en entier
+ */
+boolean FileLittleFS::append(const void* data, size_t size) {
+  ProfTimer timer(PROF_FS_WRITE);
+  boolean ok;
+  {
+    FsGuard guard;
+    if (!appendFile) {
+      appendFile = LittleFS_.open(F(path), "a");
+      if (appendFile) {
+        nextAppend = appendFiles;
+        appendFiles = this;
+        this->size = appendFile.size();
+      }
+    }
+    ok = appendFile && appendFile.write((const uint8_t*)data, size) == size;
+    if (ok)
+      this->size += size;
   }
+  if (!ok)
+    Serial.println("Erreur ecriture");
+  flashAccountWrite(path, size);
+  return ok;
+}
+
+/**
+ * @brief Lit une partie du fichier
+ *        Les ajouts en cache sont écrits avant la lecture.
+ * 
+ * @param offset position du premier octet
+ * @param data tampon de sortie
+ * @param size taille du tampon
+ * @return int nombre d'octets lus, -1 si le fichier est absent
+ */
+int FileLittleFS::read(size_t offset, void* data, size_t size) {
+  closeAppend();
+  file = LittleFS_.open(F(path), "r");
+  if (!file)
+    return -1;
+  int n = file.seek(offset) ? (int)file.read((uint8_t*)data, size) : 0;
   file.close();
-  return file != 0;
+  return n;
 }
 /**
  * @brief Ecrit un fichier text
  * 
  * @param message (String) text à mémoriser
- * @param mode "w"
+ * @param mode "w" ou "a"
  * @return boolean 
  */
 boolean FileLittleFS::writeFile(String message, const char *mode) {
-  file = LittleFS_.open(F(path), mode);
-  if (!file.print(message)) {
+  return writeFile(message.c_str(), mode);
+}
+
+/**
+ * @brief CRC32 (polynôme 0xEDB88320), calcul bit à bit
+ *        (enregistrements de quelques centaines d'octets)
+ */
+static uint32_t crc32Update(uint32_t crc, const void* data, size_t size) {
+  const uint8_t* p = (const uint8_t*)data;
+  while (size--) {
+    crc ^= *p++;
+    for (int bit = 0; bit < 8; bit++)
+      crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+  }
+  return crc;
+}
+
+uint32_t FileLittleFS::crc32(const void* data, size_t size) {
+  return ~crc32Update(0xFFFFFFFF, data, size);
+}
+
+/**
+ * @brief Nom de la copie temporaire d'un enregistrement
+ */
+static void tempName(char* name, size_t size, const char* path) {
+  snprintf(name, size, "%s" RECORD_TEMP_SUFFIX, path);
+}
+
+/**
+ * @brief Numéro d'un enregistrement existant, lu dans son seul en-tête
+ * 
+ * @return uint16_t numéro, 0 si le fichier est absent ou n'est pas un enregistrement
+ */
+static uint16_t recordSeq(const char* name) {
+  File file = LittleFS_.open(F(name), "r");
+  if (!file)
+    return 0;
+  RecordHeader header;
+  boolean ok = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+               header.magic == RECORD_MAGIC;
+  file.close();
+  return ok ? header.seq : 0;
+}
+
+/**
+ * @brief Ecrit un enregistrement binaire : en-tête (version, format, taille,
+ *        numéro, CRC) et données
+ *        Ecriture dans la copie temporaire, écriture en flash, puis
+ *        remplacement de l'enregistrement par renommage.
+ *        Sans lecture préalable (readRecord), le numéro est repris de
+ *        l'enregistrement existant : la copie temporaire est toujours plus
+ *        récente que lui.
+ * 
+ * @param format type des données
+ * @param data données
+ * @param size taille des données
+ * @return boolean true si l'enregistrement est écrit en entier
+ */
+boolean FileLittleFS::writeRecord(uint8_t format, const void* data, size_t size) {
+  ProfTimer timer(PROF_FS_WRITE);
+  char temp[sizeof(path) + sizeof(RECORD_TEMP_SUFFIX)];
+  tempName(temp, sizeof(temp), path);
+  if (!seqKnown) {
+    seq = recordSeq(path);
+    seqKnown = true;
+  }
+  RecordHeader header = { RECORD_MAGIC, RECORD_VERSION, format, (uint16_t)size, ++seq, crc32(data, size) };
+  closeAppend();
+  file = LittleFS_.open(F(temp), "w");
+  boolean ok = file &&
+               file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+               file.write((const uint8_t*)data, size) == size;
+  if (ok)
+    file.flush();
+  file.close();
+  ok = ok && LittleFS_.rename(temp, path);
+  if (!ok)
     Serial.println("Erreur ecriture");
+  this->size = ok ? (long)(sizeof(header) + size) : -1;
+  flashAccountWrite(path, sizeof(header) + size);
+  return ok;
+}
+
+/**
+ * @brief Lit et vérifie un enregistrement
+ * 
+ * @param name fichier
+ * @param data tampon de sortie, NULL : vérification seule
+ * @param seq numéro de l'enregistrement
+ * @return int taille des données, -1 si invalide
+ */
+static int readRecordFile(const char* name, uint8_t format, void* data, size_t size, uint16_t* seq) {
+  File file = LittleFS_.open(F(name), "r");
+  if (!file)
+    return -1;
+  RecordHeader header;
+  boolean ok = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+               header.magic == RECORD_MAGIC &&
+               header.version == RECORD_VERSION &&
+               header.format == format &&
+               header.size <= size;
+  uint32_t crc = 0xFFFFFFFF;
+  if (ok && data) {
+    ok = file.read((uint8_t*)data, header.size) == header.size;
+    crc = crc32Update(crc, data, header.size);
+  }
+  else if (ok) {
+    // CRC calculé par blocs, sans tampon de la taille de l'enregistrement
+    uint8_t block[64];
+    for (size_t n = header.size; ok && n > 0; ) {
+      size_t length = min(n, sizeof(block));
+      ok = file.read(block, length) == length;
+      crc = crc32Update(crc, block, length);
+      n -= length;
+    }
   }
   file.close();
-  return file != 0;
+  if (!ok || ~crc != header.crc)
+    return -1;
+  *seq = header.seq;
+  return header.size;
+}
+
+/**
+ * @brief Lit un enregistrement binaire
+ *        Si une écriture a été interrompue après l'écriture complète de la
+ *        copie temporaire, cette copie plus récente est retenue et le
+ *        renommage est terminé (recovered()). Une copie temporaire
+ *        incomplète ou plus ancienne est supprimée.
+ * 
+ * @param format type des données attendu
+ * @param data tampon de sortie
+ * @param size taille du tampon
+ * @return int taille des données lues, -1 si le fichier est absent, d'un autre
+ *         format ou d'une autre version, tronqué ou corrompu (CRC)
+ */
+int FileLittleFS::readRecord(uint8_t format, void* data, size_t size) {
+  char temp[sizeof(path) + sizeof(RECORD_TEMP_SUFFIX)];
+  tempName(temp, sizeof(temp), path);
+  closeAppend();
+  fromTemp = false;
+  uint16_t seqMain = 0, seqTemp = 0;
+  int result = readRecordFile(path, format, data, size, &seqMain);
+  if (LittleFS_.exists(temp)) {
+    if (readRecordFile(temp, format, NULL, size, &seqTemp) >= 0 &&
+        (result < 0 || (int16_t)(seqTemp - seqMain) > 0)) {
+      result = readRecordFile(temp, format, data, size, &seqMain);
+      fromTemp = result >= 0 && LittleFS_.rename(temp, path);
+      this->size = -1;
+    }
+    else
+      LittleFS_.remove(temp);
+  }
+  if (result >= 0) {
+    seq = seqMain;
+    seqKnown = true;
+  }
+  return result;
 }
 
 // Liste des fichiers présents
@@ -71,8 +343,11 @@ boolean FileLittleFS::writeFile(String message, const char *mode) {
  * @return String 
  */
 String FileLittleFS::readFile() {
+  closeAppend();
   file = LittleFS_.open(F(path), "r");
-  return file.readString();
+  String content = file.readString();
+  file.close();
+  return content;
 }
 
 /**
@@ -80,9 +355,7 @@ String FileLittleFS::readFile() {
  * @param buffer de sortie
  */
 void FileLittleFS::readFile(char* buffer) {
-  file = LittleFS_.open(F(path), "r");
-  String content = file.readString();
-  strcpy(buffer, content.c_str());
+  strcpy(buffer, readFile().c_str());
 }
 
 
@@ -91,15 +364,19 @@ boolean FileLittleFS::exist(const char *name) {
 }
 
 boolean FileLittleFS::exist() {
-  return LittleFS_.exists(path);
+  return size >= 0 || LittleFS_.exists(path);
 }
 
 void FileLittleFS::rmFile() {
-  LittleFS_.remove(path);
+  closeAppend();
+  size = -1;
+  if (LittleFS_.remove(path))
+    flashAccountRemove(path);
 }
 
 void FileLittleFS::rmFile(const char *path) {
-  LittleFS_.remove(path);
+  if (LittleFS_.remove(path))
+    flashAccountRemove(path);
 }
 
 void FileLittleFS::rmDir(const char *dir) {
@@ -111,16 +388,42 @@ void FileLittleFS::mkDir(const char *dirName) {
 }
 
 void FileLittleFS::close() {
+  closeAppend();
   file.close();
 }
 
+/**
+ * @brief Ecrit en mémoire flash les ajouts en cache
+ */
+void FileLittleFS::sync() {
+  FsGuard guard;
+  if (appendFile)
+    appendFile.flush();
+}
 
+/**
+ * @brief sync() de tous les fichiers ayant un descripteur d'ajout
+ *        (périodiquement et avant ESP.restart())
+ */
+void FileLittleFS::syncAll() {
+  FsGuard guard;
+  for (FileLittleFS* f = appendFiles; f; f = f->nextAppend)
+    f->sync();
+}
+
+/**
+ * @brief Taille du fichier, 0 s'il n'existe pas
+ *        Lue une seule fois, puis tenue à jour par les écritures
+ */
 size_t FileLittleFS::fileSize() {
-  auto file = LittleFS_.open(path, "r");
-  size_t filesize = file.size();
-  // Don't forget to clean up!
-  file.close();
-  return filesize;
+  if (size < 0) {
+    auto file = LittleFS_.open(path, "r");
+    if (!file)
+      return 0;
+    size = file.size();
+    file.close();
+  }
+  return size;
 }
 
 
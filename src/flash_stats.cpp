@@ -0,0 +1,182 @@
+/**
+ * @file flash_stats.cpp
+ * @brief Implementation du comptage des écritures en mémoire flash.
+ *
+ * Les compteurs sont tenus directement en mémoire RTC non initialisée ;
+ * la somme de contrôle est mise à jour à chaque écriture comptée pour qu'un
+ * redémarrage (ESP.restart, chien de garde) à tout instant les retrouve
+ * valides. Elle est calculée mot par mot sous flashMux : un CRC32 bit à bit
+ * y masquerait les interruptions pendant des dizaines de µs.
+ */
+#include "flash_stats.h"
+#include "files.h"
+
+// Enregistrement FLASH_STATS_FILE_NAME (voir RECORD_FORMAT_* de param_store.h)
+#define RECORD_FORMAT_FLASH_STATS 3
+#define RTC_FLASH_MAGIC 0xF1A5C0DE
+
+/**
+ * @brief Compteurs conservés lors d'un redémarrage logiciel
+ */
+RTC_NOINIT_ATTR static struct {
+  uint32_t magic;
+  FlashStats stats;
+  uint32_t sum;
+} rtcFlash;
+
+static FlashStats& stats = rtcFlash.stats;
+static portMUX_TYPE flashMux = portMUX_INITIALIZER_UNLOCKED;
+// Créneau courant = bucketBase + millis() / FLASH_BUCKET_MS
+static uint32_t bucketBase;
+// Ecritures supprimées non encore signalées (flashThrottledTake)
+static uint32_t pendingThrottled;
+static FileLittleFS* statsFile;
+
+static_assert(sizeof(FlashStats) % sizeof(uint32_t) == 0, "FlashStats : mots de 32 bits");
+
+/**
+ * @brief Somme de contrôle de la copie RTC (rotation et ou exclusif par mot)
+ */
+static uint32_t checksum() {
+  const uint32_t* word = (const uint32_t*)&rtcFlash.stats;
+  uint32_t sum = RTC_FLASH_MAGIC;
+  for (size_t i = 0; i < sizeof(FlashStats) / sizeof(uint32_t); i++)
+    sum = ((sum << 5) | (sum >> 27)) ^ word[i];
+  return sum;
+}
+
+static void updateSum() {
+  rtcFlash.magic = RTC_FLASH_MAGIC;
+  rtcFlash.sum = checksum();
+}
+
+static boolean validStats(const FlashStats& s) {
+  return s.nFiles <= MAX_FLASH_FILES && s.writeBudget >= FLASH_MIN_BUDGET;
+}
+
+/**
+ * @brief Passe au créneau courant, les créneaux écoulés sont remis à zéro
+ */
+static void advance() {
+  uint32_t current = bucketBase + millis() / FLASH_BUCKET_MS;
+  if (stats.bucket == current)
+    return;
+  for (int i = 0; stats.bucket != current && i < FLASH_RATE_BUCKETS; i++)
+    stats.buckets[++stats.bucket % FLASH_RATE_BUCKETS] = 0;
+  stats.bucket = current;
+  updateSum();
+}
+
+static uint32_t lastHour() {
+  uint32_t writes = 0;
+  for (int i = 0; i < FLASH_RATE_BUCKETS; i++)
+    writes += stats.buckets[i];
+  return writes;
+}
+
+/**
+ * @brief Compteurs d'un fichier, ajoutés si nécessaire
+ *        Table pleine : cumul dans la dernière entrée
+ */
+static FlashFileStats* fileStats(const char* path) {
+  for (uint32_t i = 0; i < stats.nFiles; i++)
+    if (strncmp(stats.files[i].path, path, FLASH_PATH_SIZE - 1) == 0)
+      return &stats.files[i];
+  if (stats.nFiles == MAX_FLASH_FILES)
+    return &stats.files[MAX_FLASH_FILES - 1];
+  FlashFileStats* file = &stats.files[stats.nFiles++];
+  strncpy(file->path, path, FLASH_PATH_SIZE - 1);
+  file->path[FLASH_PATH_SIZE - 1] = '\0';
+  return file;
+}
+
+void flashStatsInit() {
+  statsFile = new FileLittleFS(FLASH_STATS_FILE_NAME);
+  if (rtcFlash.magic != RTC_FLASH_MAGIC ||
+      rtcFlash.sum != checksum() ||
+      !validStats(stats)) {
+    // Mise sous tension : dernier enregistrement horaire
+    FlashStats saved;
+    if (statsFile->readRecord(RECORD_FORMAT_FLASH_STATS, &saved, sizeof(saved)) == sizeof(saved) &&
+        validStats(saved)) {
+      stats = saved;
+      // Durée de la coupure inconnue : débit glissant repris à zéro
+      memset(stats.buckets, 0, sizeof(stats.buckets));
+    }
+    else {
+      memset(&stats, 0, sizeof(stats));
+      stats.writeBudget = FLASH_WRITE_BUDGET;
+    }
+  }
+  // Le créneau mémorisé se poursuit après le redémarrage
+  bucketBase = stats.bucket - millis() / FLASH_BUCKET_MS;
+  updateSum();
+}
+
+void flashStatsSave() {
+  FlashStats copy;
+  flashStatsTake(&copy);
+  statsFile->writeRecord(RECORD_FORMAT_FLASH_STATS, &copy, sizeof(copy));
+}
+
+void flashAccountWrite(const char* path, size_t bytes) {
+  portENTER_CRITICAL(&flashMux);
+  FlashFileStats* file = fileStats(path);
+  file->writes++;
+  file->bytes += bytes;
+  advance();
+  if (stats.buckets[stats.bucket % FLASH_RATE_BUCKETS] < UINT16_MAX)
+    stats.buckets[stats.bucket % FLASH_RATE_BUCKETS]++;
+  updateSum();
+  portEXIT_CRITICAL(&flashMux);
+}
+
+void flashAccountRemove(const char* path) {
+  portENTER_CRITICAL(&flashMux);
+  fileStats(path)->removes++;
+  updateSum();
+  portEXIT_CRITICAL(&flashMux);
+}
+
+uint32_t flashWritesLastHour() {
+  portENTER_CRITICAL(&flashMux);
+  advance();
+  uint32_t writes = lastHour();
+  portEXIT_CRITICAL(&flashMux);
+  return writes;
+}
+
+boolean flashThrottle() {
+  portENTER_CRITICAL(&flashMux);
+  advance();
+  boolean throttle = lastHour() >= stats.writeBudget;
+  if (throttle) {
+    stats.throttled++;
+    pendingThrottled++;
+    updateSum();
+  }
+  portEXIT_CRITICAL(&flashMux);
+  return throttle;
+}
+
+uint32_t flashThrottledTake() {
+  portENTER_CRITICAL(&flashMux);
+  uint32_t throttled = pendingThrottled;
+  pendingThrottled = 0;
+  portEXIT_CRITICAL(&flashMux);
+  return throttled;
+}
+
+void flashSetBudget(uint32_t budget) {
+  portENTER_CRITICAL(&flashMux);
+  stats.writeBudget = max(budget, (uint32_t)FLASH_MIN_BUDGET);
+  updateSum();
+  portEXIT_CRITICAL(&flashMux);
+}
+
+void flashStatsTake(FlashStats* copy) {
+  portENTER_CRITICAL(&flashMux);
+  advance();
+  *copy = stats;
+  portEXIT_CRITICAL(&flashMux);
+}
@@ -7,48 +7,223 @@
  * either directly on an ESP32 or via shift registers on the ES32A08 board.
  * 
  * The functions include:
+ * - initShiftRegisters: Configures the pins/SPI buses of the selected backend.
  * - readByteInput: Reads 8 opto-isolated inputs from the ES32A08 board.
+ * - sampleInputs: Samples the inputs once per scan period into a snapshot.
  * - put74HC595: Writes an 8-bit field to the relay outputs.
  * - clear74HC595: Resets the shift registers.
  * - writeBitOutput: Writes a bit to a relay output.
- * - readBitsInput: Reads a specified input bit.
+ * - ioBegin/ioCommit: Groups several output changes into one shift and one latch.
+ * - ioFlush: Single writer of the shift registers, called once per cycle.
+ * - readBitsInput: Reads a specified input bit from the last snapshot.
  * 
  * The ES32A08 board uses bits 16-23 for output values and bits 0-7 for input data.
  * 
+ * The low level shift register access is selected at build time (const.h):
+ * bit-banged GPIO (default), ESP32 SPI peripherals (IO_BACKEND_SPI) or an
+ * in-memory mock (IO_BACKEND_MOCK) used to exercise the relay logic off-target.
+ * 
  * @note The code is conditionally compiled with the ES32A08 macro.
  * 
  * @see io.h
  */
 #include "io.h"
+#include <atomic>
 
 #ifdef ES32A08
 
-// Les bits 16..23 contiennent les valeurs en sortie
 // Les bits 0..7 contiennent les données en entrée
+// Ecrit uniquement par sampleInputs() (tâche de scrutation)
 static unsigned fieldBitIO;
 
-// Valeur à écrire dans les regsitres à décalage
+// Image des sorties : bits 16..23
+// Modifiée par compare-and-swap depuis la tâche loop et
+// les callbacks des temporisateurs (monoDebit, monoWatering...)
+static std::atomic<unsigned> outputShadow(0);
+
+// Dernière valeur écrite dans les registres à décalage
+// Lue et écrite uniquement par ioFlush()
 static unsigned outputShiftedValue;
 
+// Profondeur des transactions d'écriture en cours (ioBegin/ioCommit)
+static std::atomic<unsigned> transactionDepth(0);
+
+// Compteur de commutations GPIO depuis le dernier échantillonnage
+static unsigned gpioToggles;
+static IoStats stats;
+
 /**
- * @brief Lit les 8 entrées opto-isolée sur
- * la carte ES32A8. 
- * Contact fermé = 1 dans le champ de 8 bits
- * @return unsigned  
+ * @brief Ecriture d'une broche avec comptage des commutations
  */
-unsigned readByteInput() {
-  unsigned data = 0;
-  digitalWrite(LOAD_165, LOW);
+static inline void ioWrite(uint8_t pin, uint8_t val) {
+  digitalWrite(pin, val);
+  gpioToggles++;
+}
+
+/**
+ * @brief Lecture d'une broche avec comptage des accès
+ */
+static inline int ioRead(uint8_t pin) {
+  gpioToggles++;
+  return digitalRead(pin);
+}
+
+//---------------------------------------------------------------
+// Pilotage bas niveau des registres à décalage
+// Choisi à la compilation (const.h) :
+// - IO_BACKEND_SPI  : périphériques SPI de l'ESP32
+// - IO_BACKEND_MOCK : registres simulés en mémoire (tests hors cible)
+// - par défaut      : bit-bang des GPIO
+//---------------------------------------------------------------
+#if defined(IO_BACKEND_MOCK)
+
+// Contacts fermés (1 = fermé), positionnés par les tests
+static unsigned mockInputs;
+// Dernière valeur verrouillée dans les 74HC595
+static unsigned mockOutputs;
+static unsigned long mockLatchCount;
+
+void ioMockSetInputs(unsigned closedMask) {
+  mockInputs = closedMask & 0xff;
+}
+
+unsigned ioMockOutputs() {
+  return mockOutputs;
+}
+
+unsigned long ioMockLatchCount() {
+  return mockLatchCount;
+}
+
+void initShiftRegisters() {
+  mockOutputs = 0;
+  mockLatchCount = 0;
+}
+
+/**
+ * @brief Valeur brute du 74HC165 (contact fermé = 0)
+ */
+static unsigned shiftIn165() {
+  gpioToggles++;
+  return ~mockInputs & 0xff;
+}
+
+void put74HC595(unsigned value) {
+  gpioToggles++;
+  mockOutputs = value;
+  mockLatchCount++;
+}
+
+void clear74HC595() {
+  put74HC595(0);
+}
+
+#elif defined(IO_BACKEND_SPI)
+#include <SPI.h>
+
+// Les deux registres ont des horloges séparées : un bus SPI par registre
+// Broches affectées par la matrice GPIO (pas les broches SPI par défaut,
+// 18, 19 et 23 sont utilisées par l'encodeur rotatif)
+static SPIClass spi595(HSPI);
+static SPIClass spi165(VSPI);
+static const SPISettings spiSettings(IO_SPI_CLOCK, MSBFIRST, SPI_MODE0);
+
+void initShiftRegisters() {
+  pinMode(POWER_LED, OUTPUT);
+  digitalWrite(POWER_LED, LOW);
+
+  pinMode(LOAD_165, OUTPUT);
   digitalWrite(LOAD_165, HIGH);
+  spi165.begin(CLK_165, DATA_165, -1, -1);
+
+  pinMode(LATCH_955, OUTPUT);
+  digitalWrite(LATCH_955, LOW);
+  digitalWrite(NOE_955, 1);
+  pinMode(NOE_955, OUTPUT);
+  spi595.begin(CLOCK_955, -1, DATA_955, -1);
+
+  // Mettre les registres à décalage à zéro
+  clear74HC595();
+  digitalWrite(NOE_955, 0);
+}
+
+/**
+ * @brief Valeur brute du 74HC165 (contact fermé = 0)
+ *        Chargement parallèle puis une transaction SPI de 8 bits
+ */
+static unsigned shiftIn165() {
+  ioWrite(LOAD_165, LOW);
+  ioWrite(LOAD_165, HIGH);
+  spi165.beginTransaction(spiSettings);
+  unsigned data = spi165.transfer(0);
+  spi165.endTransaction();
+  // Une transaction SPI est comptée comme un accès
+  gpioToggles++;
+  return data;
+}
+
+/**
+ * @brief Ecrit les 24 bits des registres à décalage
+ *        en une transaction SPI de 3 octets suivie du verrouillage
+ * @param value valeur sur 24 bits à ecrire
+ */
+void put74HC595(unsigned value) {
+  uint8_t buffer[3] = {
+    (uint8_t)(value >> 16),
+    (uint8_t)(value >> 8),
+    (uint8_t)value
+  };
+  spi595.beginTransaction(spiSettings);
+  spi595.writeBytes(buffer, sizeof(buffer));
+  spi595.endTransaction();
+  gpioToggles++;
+  ioWrite(LATCH_955, 1);
+  ioWrite(LATCH_955, 0);
+}
+
+/**
+ * @brief Reset des registres à décalage
+ */
+void clear74HC595() {
+  put74HC595(0);
+}
+
+#else
+
+void initShiftRegisters() {
+  pinMode(POWER_LED, OUTPUT);
+  digitalWrite(POWER_LED, LOW);
+
+  pinMode(CLK_165, OUTPUT);
+  digitalWrite(CLK_165, LOW);
+  pinMode(LOAD_165, OUTPUT);
+  digitalWrite(LOAD_165, HIGH);
+  pinMode(DATA_165, INPUT);
+
+  pinMode(CLOCK_955, OUTPUT);
+  pinMode(LATCH_955, OUTPUT);
+  digitalWrite(NOE_955, 1);
+  pinMode(NOE_955, OUTPUT);
+
+  // Mettre les registres à décalage à zéro  
+  clear74HC595();
+  digitalWrite(NOE_955, 0);
+  pinMode(DATA_955, OUTPUT);
+}
+
+/**
+ * @brief Valeur brute du 74HC165 (contact fermé = 0)
+ */
+static unsigned shiftIn165() {
+  unsigned data = 0;
+  ioWrite(LOAD_165, LOW);
+  ioWrite(LOAD_165, HIGH);
   for (int i = 0; i < 8; i++) {
-    data = (data << 1) | (digitalRead(DATA_165));
-    digitalWrite(CLK_165, HIGH);
-    digitalWrite(CLK_165, LOW);
+    data = (data << 1) | (ioRead(DATA_165));
+    ioWrite(CLK_165, HIGH);
+    ioWrite(CLK_165, LOW);
   }
-  fieldBitIO = fieldBitIO & 0xFFFF00;
-  // Contact fermé = 0 sur la sortie de l'optocoupleur
-  fieldBitIO = fieldBitIO | (~data & 0xff);
-  return fieldBitIO;
+  return data;
 }
 
 /**
@@ -63,17 +238,17 @@ void put74HC595(unsigned value) {
   for (int i = 0; i < 24; i++) {
     bool bit = value & mask;
     mask >>= 1;
-    digitalWrite(DATA_955, bit ? 1 : 0);
+    ioWrite(DATA_955, bit ? 1 : 0);
 #ifdef IO_DEBUG    
     if (i % 8 == 0)
       Serial.print(' ');
     Serial.print(bit ? 1 : 0);
 #endif    
-    digitalWrite(CLOCK_955, 1);
-    digitalWrite(CLOCK_955, 0);
+    ioWrite(CLOCK_955, 1);
+    ioWrite(CLOCK_955, 0);
   }
-  digitalWrite(LATCH_955, 1);
-  digitalWrite(LATCH_955, 0);
+  ioWrite(LATCH_955, 1);
+  ioWrite(LATCH_955, 0);
 #ifdef IO_DEBUG 
   Serial.println();
 #endif  
@@ -84,12 +259,71 @@ void put74HC595(unsigned value) {
  */
 void clear74HC595() {
   for (int i = 0; i < 24; i++) {
-    digitalWrite(DATA_955, 0);
-    digitalWrite(CLOCK_955, 1);
-    digitalWrite(CLOCK_955, 0);
+    ioWrite(DATA_955, 0);
+    ioWrite(CLOCK_955, 1);
+    ioWrite(CLOCK_955, 0);
+  }
+  ioWrite(LATCH_955, 1);
+  ioWrite(LATCH_955, 0);
+}
+#endif
+
+/**
+ * @brief Lit les 8 entrées opto-isolée sur
+ * la carte ES32A8. 
+ * Contact fermé = 1 dans le champ de 8 bits
+ * @return unsigned  
+ */
+unsigned readByteInput() {
+  unsigned data = shiftIn165();
+  // Contact fermé = 0 sur la sortie de l'optocoupleur
+  fieldBitIO = ~data & 0xff;
+  return fieldBitIO | outputShadow.load();
+}
+
+/**
+ * @brief Echantillonne les entrées une fois par cycle de scrutation
+ *        Toutes les lectures d'entrées (readBitsInput) utilisent cet
+ *        instantané jusqu'au prochain échantillonnage.
+ *        Appelé au début de localLoop (INTERVAL_IO_SCRUT)
+ * @return unsigned champ des E/S
+ */
+unsigned sampleInputs() {
+  // Commutations GPIO cumulées depuis l'échantillonnage précédent
+  stats.lastScanToggles = gpioToggles;
+  if (gpioToggles > stats.maxScanToggles)
+    stats.maxScanToggles = gpioToggles;
+  gpioToggles = 0;
+  unsigned value = readByteInput();
+  stats.inputTimestamp = millis();
+  stats.scans++;
+  return value;
+}
+
+/**
+ * @brief Statistiques d'acquisition des E/S
+ * @return const IoStats* 
+ */
+const IoStats* ioStats() {
+  return &stats;
+}
+
+/**
+ * @brief Ecrit les sorties dans les registres si elles ont changé
+ *        Seul point d'écriture des registres 74HC595 : appelé une fois
+ *        par cycle de scrutation (scanCycle). Les callbacks des temporisateurs
+ *        ne font que poster leurs modifications dans outputShadow.
+ *        Aucune écriture tant qu'une transaction est ouverte, pour ne
+ *        jamais verrouiller un groupe de relais à moitié modifié.
+ */
+void ioFlush() {
+  if (transactionDepth.load() != 0)
+    return;
+  unsigned value = outputShadow.load() & 0x0FF0000;
+  if (value != outputShiftedValue) {
+    outputShiftedValue = value;
+    put74HC595(outputShiftedValue);
   }
-  digitalWrite(LATCH_955, 1);
-  digitalWrite(LATCH_955, 0);
 }
 
 /**
@@ -99,32 +333,74 @@ void clear74HC595() {
  * Exemple 
  * 0x010000 = bit 0 (relais 1)
  * 0x800000 = bit 7 (relais 8)
+ * Peut être appelé depuis un callback de temporisateur : la modification
+ * est postée dans l'image des sorties (compare-and-swap), l'écriture des
+ * registres est faite par ioFlush() au cycle suivant.
  * @param mask  spécifie le bit 
  * @param value 0 ou 1
  */
 void writeBitOutput(unsigned mask, int value) {
-  unsigned outputShiftedValue_1;
-  if (value != 0)
-    fieldBitIO = fieldBitIO | mask;
-  else
-    fieldBitIO = fieldBitIO & ~mask;
-  // Isoler les 8 bits de poids forts
-  // Les 8 bits de poids faible contient l'état des entrées
-  outputShiftedValue_1 = fieldBitIO & 0x0FF0000;
-  if (outputShiftedValue_1 != outputShiftedValue) {
-    outputShiftedValue = outputShiftedValue_1;
-    put74HC595(outputShiftedValue);
-  }
+  unsigned current = outputShadow.load();
+  unsigned next;
+  do {
+    next = (value != 0) ? (current | mask) : (current & ~mask);
+  } while (!outputShadow.compare_exchange_weak(current, next));
+}
+
+/**
+ * @brief Ouvre une transaction d'écriture des sorties
+ *        Les modifications (on/off) sont regroupées : ioFlush() n'écrit
+ *        pas les registres avant la fermeture de la transaction.
+ *        Les transactions peuvent être imbriquées.
+ */
+void ioBegin() {
+  transactionDepth++;
+}
+
+/**
+ * @brief Ferme une transaction d'écriture des sorties
+ *        Les sorties commutent simultanément au prochain ioFlush()
+ *        suivant la fermeture de la transaction la plus externe.
+ */
+void ioCommit() {
+  unsigned depth = transactionDepth.load();
+  while (depth > 0 && !transactionDepth.compare_exchange_weak(depth, depth - 1))
+    ;
 }
 /**
  * @brief Lit un bit d'entrée spécifiée 
  * par son masque. Exemple :
  * Bit 0 masque 0x01
  * Bit 7 masque 0x80
+ * Les entrées proviennent du dernier échantillonnage (sampleInputs),
+ * aucun accès au registre 74HC165.
  * @param mask 
  * @return boolean valeur du bit
  */
 boolean readBitsInput(unsigned mask) {
-  return (mask <= 0x80) ? readByteInput() & mask : fieldBitIO & mask;
+  return (fieldBitIO | outputShadow.load()) & mask;
+}
+#else
+// Entrées sur gpio ESP32 : lecture directe, pas d'échantillonnage
+static IoStats stats;
+
+unsigned sampleInputs() {
+  stats.inputTimestamp = millis();
+  stats.scans++;
+  return 0;
+}
+
+const IoStats* ioStats() {
+  return &stats;
+}
+
+// Sorties sur gpio ESP32 : chaque écriture est immédiate
+void ioBegin() {
+}
+
+void ioCommit() {
+}
+
+void ioFlush() {
 }
 #endif
\ No newline at end of file
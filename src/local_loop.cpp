@@ -89,6 +89,7 @@ unsigned Q_D2(int nButton) {
  * @brief Message remplissage surpresseur sur l'écran LCD
  */
 void lcdSupressorWaitMsg() {
+	LcdGuard guard;
 	display = nullFunc;
 	backLightOn();
 	lcdPrintString(SUPRESSOR_FILLING, 0, 1, true);
@@ -100,6 +101,7 @@ void lcdSupressorWaitMsg() {
  * @brief Information erreur remplissage surpresseur sur l'écran LCD
  */
 void lcdSupressorFaultMsg() {
+	LcdGuard guard;
 	display = nullFunc;
 	backLightOn();
 	lcdPrintString(SURPRESSOR_FAULT, 0, 1, true);
@@ -110,6 +112,7 @@ void lcdSupressorFaultMsg() {
  * @brief Message défaut sur pompe supresseur sur l'écran LCD
  */
 void lcdPumpFault() {
+	LcdGuard guard;
 	display = nullFunc;
 	backLightOn();
 	lcdPrintString(PUMP_DEFAULT, 0, 1, true);
@@ -135,6 +138,7 @@ void lcdReboot() {
 	lcdClear();
 	lcdPrintString(REBOOT, 1, 0, true);
 	delay(2000);
+	persistFlush();
 	ESP.restart();
 }
 
@@ -143,6 +147,10 @@ void lcdReboot() {
  * 
  */
 void localLoop(void) {
+	// Un seul échantillonnage des entrées par cycle,
+	// les lectures suivantes utilisent l'instantané
+	sampleInputs();
+
 	// Commande manuelle arrosage
 	// Tâche la moins prioritaire
   	//  - Priorité 1 : supresseur
@@ -199,7 +207,10 @@ void localLoop(void) {
 		// Force l'affichage de l'index tournant
 		isLcdDisplayOn = true;
 		// Affichage lcd sans timeout
-		lcd.displayOn(); // dispplayOn set backLight
+		{
+			LcdGuard guard;
+			lcd.displayOn(); // dispplayOn set backLight
+		}
 		// Temporise la durée d'affichage sur LCD
  		t_start(tache_t_backLight2);
 		electricalPanelOpen = true;
@@ -232,13 +243,13 @@ void localLoop(void) {
 			// Reset message TOPIC_DEFAUT_SUPRESSEUR
 			first = false;
 			// Message vers HA et appli Android
-			mqttClient.publish(TOPIC_DEFAUT_SUPRESSOR, "off");
+			mqttPublish(TOPIC_DEFAUT_SUPRESSOR, "off");
 		}
 		// Si le surpresseur est autorisé	
 		if (cDlyParam->get(SUPRESSOR_EN)) {
 			if (!bSupressorEnLog) {
 				// Enregistrer inconditionnelement 
-				logsWrite("Surpresseur activé");
+				eventWrite(EV_SUPRESSOR_EN, 0, 0, NULL);
 				bSupressorEnLog = true;
 				#ifdef DEBUG_OUTPUT
 				Serial.println("Surpresseur activé");
@@ -254,24 +265,29 @@ void localLoop(void) {
 				//   Nota : si les EV sont coupées, la pompe débite dans le surpresseur.
 				//   Voir plan hydraulique			
 				if (isTankFilling || isWatering) {
+					// Etat avant l'arrêt, pour les logs
+					boolean wasTankFilling = isTankFilling;
+					boolean wasWatering = isWatering;
 					isWatering = false;
 					isTankFilling = false;
 					t_stop(tache_t_tankFilling);
 					t_stop(tache_t_watering);
+					ioBegin();
 					off(O_TRANSFO);
 					off(O_EV_IRRIGATION);
 					off(O_EV_ARROSAGE);
-					if (isTankFilling)
-						writeLogs("Arrèt remplissage réservoir");
-					if (isWatering)
-						writeLogs("Arrèt arrosage");
+					ioCommit();
+					if (wasTankFilling)
+						writeEvent(EV_TANK_FILLING_STOP);
+					if (wasWatering)
+						writeEvent(EV_WATERING_STOP);
 				}
 				lcdSupressorWaitMsg();
 				// Mise à jour dynamique du timeout
 				setDelay(tache_t_surpressorFilling, cvrtic(cDlyParam->get(TIME_SUPRESSOR) * 1000));
 				t_start(tache_t_surpressorFilling);
 				// Publier pour HA et appli Android
-				mqttClient.publish(TOPIC_DEFAUT_SUPRESSOR, "off");
+				mqttPublish(TOPIC_DEFAUT_SUPRESSOR, "off");
 				// Mettre systématiquement la pompe en route  
 				on(O_POMPE);
 
@@ -290,7 +306,7 @@ void localLoop(void) {
 						// Serial.println("n_supressorFillingInTime++");
 					}
 				}
-				writeLogs("Remplissage surpresseur");
+				writeEvent(EV_SUPRESSOR_FILLING);
 			}
 		}
 		else if (!bSupressorDisLog) {
@@ -300,7 +316,7 @@ void localLoop(void) {
 			bSupressorDisLog = true;
 			bSupressorEnLog = false;
 			// Enregistrer inconditionnelement 
-			logsWrite("Surpresseur desactivé");
+			eventWrite(EV_SUPRESSOR_DIS, 0, 0, NULL);
 		}	
 		// Relance manuelle pompe sur timeout (monoSurpressorFilling coupe la pompe)
 		// Une relance autorisée
@@ -311,7 +327,7 @@ void localLoop(void) {
 			startSupressorFilling = false;
 			// Interdit une autre tentative
 			startSupressorFilling2 = true;
-			mqttClient.publish(TOPIC_DEFAUT_SUPRESSOR, "off");
+			mqttPublish(TOPIC_DEFAUT_SUPRESSOR, "off");
 		}  		
 	}
 	// Ouverture du contact supresseur (fin remplissage)
@@ -326,7 +342,7 @@ void localLoop(void) {
 		if (cDlyParam->get(SUPRESSOR_EN)) {
 			ioDisplay();
 			display = ioDisplay;
-			writeLogs("Fin remplissage surpresseur");
+			writeEvent(EV_SUPRESSOR_FILLED);
 		}
 	}
 
@@ -335,7 +351,7 @@ void localLoop(void) {
 	static unsigned surpressorSecurityFlag;
 	if (supressorFillingSecurity && !surpressorSecurityFlag) {
 		surpressorSecurityFlag = true;
-		fileDlyParam->writeFile(cDlyParam->getStr(), "w");
+		persistParam(fileDlyParam, cDlyParam);
 		// Serial.println("supressorFillingSecurity && !surpressorSecurityFlag");
 	}
 	if (!supressorFillingSecurity && surpressorSecurityFlag) {
@@ -358,7 +374,7 @@ void localLoop(void) {
 		erreurSupresseurEvent = true;
 		lcdSupressorFaultMsg();
 		onSingleClick = reArm;
-		writeLogs("Erreur surpresseur");
+		writeEvent(EV_SUPRESSOR_FAULT);
 	}
 	if (erreurPompe) {
 		erreurPompe = false;
@@ -366,7 +382,7 @@ void localLoop(void) {
 		erreurPompEvent = true;
 		lcdPumpFault();
 		onSingleClick = lcdReboot;
-		writeLogs("Erreur pompe");
+		writeEvent(EV_PUMP_FAULT);
 	}
 	logsUpdate();
 }
@@ -0,0 +1,73 @@
+/**
+ * @file log_event.cpp
+ * @brief Mise en forme des événements du journal.
+ */
+#include <time.h>
+#include "log_event.h"
+#include "log_store.h"
+
+// Messages des événements, par code
+static const char* const eventTexts[N_EVENTS] = {
+  "",
+  "PAC sous tension",
+  "PAC hors tension",
+  "App. cuisson sous tension",
+  "App. cuisson hors tension",
+  "VMC sous tension",
+  "VMC hors tension",
+  "Arrosage en cours",
+  "Fin arrosage",
+  "Remplissage réservoir",
+  "Arrêt remplissage",
+  "Irrigation façade SUD",
+  "Fin irrigation façade SUD",
+  "Surpresseur activé",
+  "Surpresseur desactivé",
+  "Arrèt remplissage réservoir",
+  "Arrèt arrosage",
+  "Remplissage surpresseur",
+  "Fin remplissage surpresseur",
+  "Erreur surpresseur",
+  "Erreur pompe",
+  "on",
+  "off",
+  "logs non écrits (budget flash)",
+};
+
+int formatEvent(uint8_t type, const uint8_t* data, size_t size, char* buffer, size_t length) {
+  LogEvent event;
+  if (type != LOG_TYPE_EVENT || size < sizeof(LogEvent)) {
+    // Ligne de texte déjà datée
+    size = min(size, length - 1);
+    memcpy(buffer, data, size);
+    buffer[size] = '\0';
+    return size;
+  }
+  memcpy(&event, data, sizeof(LogEvent));
+  time_t time = event.time;
+  struct tm info;
+  gmtime_r(&time, &info);
+  int n = snprintf(buffer, length, "%02d/%02d/%4d %02d:%02d:%02d - ",
+    info.tm_mday, info.tm_mon + 1, info.tm_year + 1900, info.tm_hour, info.tm_min, info.tm_sec);
+  // Tampon rempli par la date : length - n ne doit pas devenir négatif (size_t)
+  n = min(n, (int)length - 1);
+  const char* text = event.code < N_EVENTS ? eventTexts[event.code] : "?";
+  switch (event.code) {
+  case EV_TEXT:
+    n += snprintf(buffer + n, length - n, "%.*s",
+      (int)(size - sizeof(LogEvent)), (const char*)data + sizeof(LogEvent));
+    break;
+  case EV_CATCH_UP_ON:
+  case EV_CATCH_UP_OFF:
+    n += snprintf(buffer + n, length - n, "Rattrapage %02d:%02d dev %d %s",
+      event.value / 60, event.value % 60, event.device, text);
+    break;
+  case EV_THROTTLED:
+    n += snprintf(buffer + n, length - n, "%u %s", event.value, text);
+    break;
+  default:
+    n += snprintf(buffer + n, length - n, "%s", text);
+    break;
+  }
+  return min(n, (int)length - 1);
+}
@@ -0,0 +1,177 @@
+/**
+ * @file log_store.cpp
+ * @brief Implementation du journal circulaire segmenté.
+ */
+#include "log_store.h"
+
+/**
+ * @brief Vérifie l'enregistrement à la position offset
+ *
+ * @param buffer contenu du segment
+ * @param length taille du contenu
+ * @param offset position de l'enregistrement
+ * @param header en-tête lu
+ * @return size_t taille de l'enregistrement, 0 s'il est incomplet ou invalide
+ */
+static size_t record(const uint8_t* buffer, size_t length, size_t offset, LogHeader* header) {
+  if (offset + sizeof(LogHeader) > length)
+    return 0;
+  memcpy(header, buffer + offset, sizeof(LogHeader));
+  size_t size = sizeof(LogHeader) + header->size;
+  if (header->seq == 0 || offset + size > length)
+    return 0;
+  uint32_t crc = FileLittleFS::crc32(buffer + offset + sizeof(header->check), size - sizeof(header->check));
+  return header->check == (uint16_t)crc ? size : 0;
+}
+
+LogStore::LogStore() {
+  char name[16];
+  for (int i = 0; i < LOG_SEGMENTS; i++) {
+    snprintf(name, sizeof(name), LOG_SEGMENT_NAME, i);
+    segments[i] = new FileLittleFS(name);
+    first[i] = 0;
+    used[i] = 0;
+  }
+  head = 0;
+  next = 1;
+  mutex = NULL;
+}
+
+/**
+ * @brief Parcourt un segment
+ *
+ * @param segment numéro du segment
+ * @param buffer tampon de LOG_SEGMENT_SIZE octets
+ * @param last dernier numéro valide du segment (0 si vide)
+ * @return int taille du fichier lue, -1 si le segment est absent
+ */
+int LogStore::scan(int segment, uint8_t* buffer, uint32_t* last) {
+  int n = segments[segment]->read(0, buffer, LOG_SEGMENT_SIZE);
+  first[segment] = 0;
+  used[segment] = 0;
+  *last = 0;
+  LogHeader header;
+  size_t size;
+  while (n > 0 && (size = record(buffer, n, used[segment], &header)) != 0 && header.seq > *last) {
+    if (!first[segment])
+      first[segment] = header.seq;
+    *last = header.seq;
+    used[segment] += size;
+  }
+  return n;
+}
+
+void LogStore::begin(boolean clear) {
+  if (!mutex)
+    mutex = xSemaphoreCreateMutex();
+  if (clear) {
+    this->clear();
+    return;
+  }
+  uint8_t* buffer = new uint8_t[LOG_SEGMENT_SIZE];
+  uint32_t last[LOG_SEGMENTS];
+  int length[LOG_SEGMENTS];
+  lock();
+  head = 0;
+  for (int i = 0; i < LOG_SEGMENTS; i++) {
+    length[i] = scan(i, buffer, &last[i]);
+    if (last[i] > last[head])
+      head = i;
+  }
+  next = last[head] + 1;
+  // Enregistrement incomplet : le segment courant n'est plus complété
+  if (length[head] > (int)used[head])
+    nextSegment();
+  unlock();
+  delete[] buffer;
+}
+
+/**
+ * @brief Passe au segment suivant (le plus ancien) et l'efface
+ */
+void LogStore::nextSegment() {
+  head = (head + 1) % LOG_SEGMENTS;
+  if (segments[head]->exist())
+    segments[head]->rmFile();
+  first[head] = 0;
+  used[head] = 0;
+}
+
+uint32_t LogStore::append(const void* data, size_t size, uint8_t type) {
+  uint8_t buffer[sizeof(LogHeader) + LOG_MAX_RECORD];
+  LogHeader header;
+  header.size = min(size, (size_t)LOG_MAX_RECORD);
+  header.type = type;
+  size = sizeof(LogHeader) + header.size;
+  lock();
+  if (used[head] + size > LOG_SEGMENT_SIZE)
+    nextSegment();
+  header.seq = next;
+  memcpy(buffer, &header, sizeof(LogHeader));
+  memcpy(buffer + sizeof(LogHeader), data, header.size);
+  header.check = (uint16_t)FileLittleFS::crc32(buffer + sizeof(header.check), size - sizeof(header.check));
+  memcpy(buffer, &header.check, sizeof(header.check));
+  uint32_t seq = 0;
+  if (segments[head]->append(buffer, size)) {
+    seq = next++;
+    if (!first[head])
+      first[head] = seq;
+    used[head] += size;
+  }
+  else
+    // Fichier dans un état inconnu : nouveau segment au prochain ajout
+    used[head] = LOG_SEGMENT_SIZE;
+  unlock();
+  return seq;
+}
+
+void LogStore::clear() {
+  lock();
+  for (int i = 0; i < LOG_SEGMENTS; i++) {
+    if (segments[i]->exist())
+      segments[i]->rmFile();
+    first[i] = 0;
+    used[i] = 0;
+  }
+  head = 0;
+  unlock();
+}
+
+uint32_t LogStore::read(uint32_t from, LogCallback callback, void* context) {
+  uint8_t* buffer = new uint8_t[LOG_SEGMENT_SIZE];
+  // Numéro postérieur au journal (effacé puis redémarré) : tout relire
+  if (from > next)
+    from = 0;
+  for (;;) {
+    lock();
+    // Segment contenant from : plus grand premier numéro <= from,
+    // à défaut le plus ancien segment
+    int segment = -1;
+    for (int i = 0; i < LOG_SEGMENTS; i++) {
+      if (!first[i])
+        continue;
+      if (segment < 0 ||
+          (first[i] <= from && (first[segment] > from || first[i] > first[segment])) ||
+          (first[i] > from && first[segment] > from && first[i] < first[segment]))
+        segment = i;
+    }
+    int n = segment < 0 ? 0 : segments[segment]->read(0, buffer, used[segment]);
+    unlock();
+    LogHeader header;
+    size_t offset = 0, size;
+    uint32_t last = from;
+    while (n > 0 && (size = record(buffer, n, offset, &header)) != 0) {
+      if (header.seq >= from) {
+        callback(header.seq, header.type, buffer + offset + sizeof(LogHeader), header.size, context);
+        last = header.seq + 1;
+      }
+      offset += size;
+    }
+    // Fin du journal
+    if (last == from)
+      break;
+    from = last;
+  }
+  delete[] buffer;
+  return from ? from : next;
+}
@@ -17,12 +17,13 @@
  * The function uses static boolean flags to keep track of the previous state of each
  * port and logs messages when the state changes from off to on or from on to off.
  * 
- * The log messages are written using the writeLogs function, and debug messages are
+ * The log events are written in binary form using the writeEvent function (text is
+ * produced only when the log is read, see log_event.h), and debug messages are
  * printed to the Serial output if DEBUG_OUTPUT_LOOP2 is defined.
  * 
  * @note The function assumes that the gpioState function is available to get the
- *       current state of a GPIO port, and the writeLogs function is available to
- *       write log messages.
+ *       current state of a GPIO port, and the writeEvent function is available to
+ *       write log events.
  */
 #include "logs.h"
 #include "io.h"
@@ -43,7 +44,7 @@ void logsUpdate() {
 #ifdef DEBUG_OUTPUT_LOOP2
     Serial.printf("\n%02d:%02d PAC sous tension\n", h, m);
 #endif
-    writeLogs("PAC sous tension");
+    writeEvent(EV_PAC_ON);
   }
   else if (!outputState && !flagNP) {
     flagP = false;
@@ -51,7 +52,7 @@ void logsUpdate() {
 #ifdef DEBUG_OUTPUT_LOOP2
     Serial.printf("\n%02d:%02d PAC hors tension\n", h, m);
 #endif
-    writeLogs("PAC hors tension");
+    writeEvent(EV_PAC_OFF);
   }
 
   // Vanne EST
@@ -64,7 +65,7 @@ void logsUpdate() {
 // #ifdef DEBUG_OUTPUT_LOOP2
 //     Serial.printf("\n%02d:%02d EV EST sous tension\n", h, m);
 // #endif
-//     writeLogs("Irrigation façade SUD");
+//     writeEvent(EV_VANNE_EST_ON);
 //   }
 //   else if (!outputState && !flagNE) {
 //     flagE = false;
@@ -72,7 +73,7 @@ void logsUpdate() {
 // #ifdef DEBUG_OUTPUT_LOOP2
 //     Serial.printf("\n%02d:%02d EV EST hors tension\n", h, m);
 // #endif
-//     writeLogs("Fin irrigation façade SUD");
+//     writeEvent(EV_VANNE_EST_OFF);
 //   }
 
   // Electroménager
@@ -85,7 +86,7 @@ void logsUpdate() {
 #ifdef DEBUG_OUTPUT_LOOP2
     Serial.printf("\n%02d:%02d App. cuisson sous tension\n", h, m);
 #endif
-    writeLogs("App. cuisson sous tension");
+    writeEvent(EV_COOK_ON);
   }
   else if (!outputState && !flagNF) {
     flagF = false;
@@ -93,7 +94,7 @@ void logsUpdate() {
 #ifdef DEBUG_OUTPUT_LOOP2
     Serial.printf("\n%02d:%02d App. cuisson sous tension\n", h, m);
 #endif
-    writeLogs("App. cuisson hors tension");
+    writeEvent(EV_COOK_OFF);
   }
 
   // VMC
@@ -106,7 +107,7 @@ void logsUpdate() {
 #ifdef DEBUG_OUTPUT_LOOP2
     Serial.printf("\n%02d:%02d VMC sous tension\n", h, m);
 #endif
-    writeLogs("VMC sous tension");
+    writeEvent(EV_VMC_ON);
   }
   else if (!outputState && !flagNV) {
     flagV = false;
@@ -114,7 +115,7 @@ void logsUpdate() {
 #ifdef DEBUG_OUTPUT_LOOP2
     Serial.printf("\n%02d:%02d VMC hors tension\n", h, m);
 #endif
-    writeLogs("VMC hors tension");
+    writeEvent(EV_VMC_OFF);
   }
 
   // Arrosage
@@ -127,7 +128,7 @@ void logsUpdate() {
 #ifdef DEBUG_OUTPUT_LOOP2
     Serial.printf("\n%02d:%02d Arrosage\n", h, m);
 #endif
-    writeLogs("Arrosage en cours");
+    writeEvent(EV_WATERING_ON);
   }
   else if (!outputState && !flagNA) {
     flagA = false;
@@ -135,7 +136,7 @@ void logsUpdate() {
 #ifdef DEBUG_OUTPUT_LOOP2
     Serial.printf("\n%02d:%02d Fin arrosage\n", h, m);
 #endif
-    writeLogs("Fin arrosage");
+    writeEvent(EV_WATERING_OFF);
   }
 
   // Irrigation
@@ -148,7 +149,7 @@ void logsUpdate() {
 #ifdef DEBUG_OUTPUT_LOOP2
     Serial.printf("\n%02d:%02d Remplissage réservoir\n", h, m);
 #endif
-    writeLogs("Remplissage réservoir");
+    writeEvent(EV_TANK_FILLING_ON);
   }
   else if (!outputState && !flagNR) {
     flagR = false;
@@ -156,6 +157,6 @@ void logsUpdate() {
 #ifdef DEBUG_OUTPUT_LOOP2
     Serial.printf("\n%02d:%02d Arrêt remplissage réservoir\n", h, m);
 #endif
-    writeLogs("Arrêt remplissage");
+    writeEvent(EV_TANK_FILLING_OFF);
   }
 }
\ No newline at end of file
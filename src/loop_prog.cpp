@@ -145,6 +145,7 @@
  */
 #include "loop_prog.h"
 #include "io.h"
+#include "scan.h"
 
 /*
   L'IHM locale est réalisée à l'aide d'un afficheur LCD 20x4
@@ -458,20 +459,27 @@ void _stopVMC() {
 
 void _startWateringLemon() {
   commun2_1();
+  CtrlGuard guard;
+  ioBegin();
   on(O_TRANSFO);
   on(O_EV_EST);
+  ioCommit();
   t_start(tache_t_cmdEvEst);
 }
 
 void _stopWateringLemon() {
   commun2_1();
+  CtrlGuard guard;
+  ioBegin();
   off(O_EV_EST);
   off(O_TRANSFO);
+  ioCommit();
   t_stop(tache_t_cmdEvEst);
 }
 
 void _startPowerPac() {
   commun2_1();
+  CtrlGuard guard;
   irSendPacOff = false;
   on(O_PAC);
 #ifdef PERSISTANT_PAC  
@@ -485,6 +493,7 @@ void _startPowerPac() {
 
 void _stopPowerPac() {
   commun2_1();
+  CtrlGuard guard;
   t_start(tache_t_monoPacOff); // arrêt temporisé de la PAC
   irSendPacOff = true;
 #ifdef PERSISTANT_PAC 
@@ -511,11 +520,12 @@ void _ioDisplay() {
 void _ioDisplayAndValidateDlyParam() {
   onLoopTic = nullFunc;
   onRotary = nullFunc;
-  fileDlyParam->writeFile(cDlyParam->getStr(), "w");
+  persistParam(fileDlyParam, cDlyParam);
   ioDisplay();
 }
 
 void reboot() {
+  persistFlush();
   ESP.restart();
 }
 
@@ -529,6 +539,7 @@ void _summerTimeOn() {
   cDlyParam->set(SUMMER_TIME, SUMMER_TIME_OFFSET);
   apply();
   // Serial.println("_summerTimeOn");
+  persistFlush();
   ESP.restart();
 }
 
@@ -537,6 +548,7 @@ void _summerTimeOff() {
   cDlyParam->set(SUMMER_TIME, WINTER_TIME_OFFSET);
   apply();
   // Serial.println("_summerTimeOff");
+  persistFlush();
   ESP.restart();
 }
 
@@ -562,7 +574,7 @@ void _logOff() {
 void updateScheduledGlobalParam() {
   // onLoopTic = nullFunc;
   display = nullFunc;
-  fileGlobalScheduledParam->writeFile(cGlobalScheduledParam->getStr(), "w");
+  persistParam(fileGlobalScheduledParam, cGlobalScheduledParam);
   msgOk = MSG_OK;
   onLoopTic = buttonFuncParam;
 }
@@ -621,7 +633,7 @@ void _disableVmcSched() {
 // Commun aux fonctions appelées par buttonFuncLevel2_2_X
 //----------------------------------------------------------------------
 void apply() {
-  fileDlyParam->writeFile(cDlyParam->getStr(), "w");
+  persistParam(fileDlyParam, cDlyParam);
   msgOk = MSG_OK;
   onLoopTic = buttonFuncParam;
 }
@@ -891,7 +903,10 @@ void encoderLevel0Task() {
   // Affichage lcd sans timeout
   t_stop(tache_t_backLight2);
   // Bloquer la rotation de l'index
-  lcd.displayOn();
+  {
+    LcdGuard guard;
+    lcd.displayOn();
+  }
   isLcdDisplayOn = false;
   lcdPrintString(Select_function, 0, 1, true);
   lcdPrintString(Push_to_validate, 1, 1, true);
@@ -972,7 +987,7 @@ void buttonFuncLevel0() {
   setBoundaries(0, (sizeof(msgRotary) / sizeof(msgRotary[0])) - 1);
   setEncoder(0);
   rotary = 0;
-  lcd.clear();
+  lcdClear();
   // Appel direct à l'init
   encoderLevel0Task();
   // Puis appel à chaque nouvelle rotation de l'encodeur
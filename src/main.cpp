@@ -196,6 +196,64 @@
  *  - Update display strategy
  *  @version 2026.07.25
  *  - Update display strategy 
+ *  @version 2026.10.17
+ *  - Table précompilée des actions programmées (schedule.h), publication du prochain
+ *    événement sur homecontrol/next_event
+ *  - Rattrapage des événements programmés manqués (reboot de 01:01, OTA, blocage de loop)
+ *  - schedule() appelé au changement de minute de l'horloge et non plus toutes les 60 s
+ *    (dérive, minutes sautées, redémarrage de 01:01 manqué)
+ *  - Echantillonnage unique des entrées 74HC165 par cycle (sampleInputs), statistiques
+ *    sur homecontrol/io_stats
+ *  - Pilote SPI des registres à décalage (IO_BACKEND_SPI) et registres simulés (IO_BACKEND_MOCK)
+ *  - Transactions d'écriture des relais (ioBegin/ioCommit) : pompe, transfo et vannes
+ *    commutent en un seul verrouillage
+ *  - Image des sorties atomique (compare-and-swap) partagée avec les callbacks des
+ *    temporisateurs, écriture unique des registres par cycle (ioFlush)
+ *  - Tâche de scrutation à période fixe (SCAN_TASK) épinglée sur le coeur 0 : entrées,
+ *    localLoop, sorties. Durées min/moy/max et gigue sur homecontrol/scan_stats
+ *  - Histogrammes des durées par section (loop, MQTT, Alexa, localLoop, schedule,
+ *    display, écritures LittleFS, gigue) sur homecontrol/profile, remplace EXEC_TIME_MEASURE
+ *  - Simulateur en temps accéléré sur la plateforme native (scénario d'entrées, trace des
+ *    relais), remplace TIME_SIMULATOR
+ *  - Lecture des plages (Param::setParam) en une passe sans allocation, validation des
+ *    heures, minutes et enable : paramètres rejetés journalisés, plages courantes conservées
+ *  - Paramètres mémorisés en binaire (param_store.h) : en-tête versionné et CRC32, fichier
+ *    corrompu détecté, conversion automatique des anciens fichiers texte
+ *  - Param : seules les plages modifiées sont réécrites dans leur emplacement de largeur
+ *    fixe de la chaine, au moment de sa lecture (getStr)
+ *  - Schéma des temporisations, autorisations et états persistants (param_schema.h) :
+ *    bornes, valeurs par défaut et butées des menus de réglage communes, valeurs hors
+ *    bornes rejetées, schéma publié sur homecontrol/param_schema, SimpleParam sans allocation
+ *  - Enregistrement différé des temporisations, autorisations et états persistants :
+ *    écritures regroupées sur PERSIST_WINDOW par la tâche PERSIST_TASK, hors callbacks
+ *    MQTT, enregistrement forcé avant chaque ESP.restart() et en fin de mise à jour OTA
+ *  - Comptage des écritures flash par fichier (flash_stats.h), débit glissant sur une heure,
+ *    publié sur homecontrol/flash_stats ; logs suspendus au-delà du budget d'écriture
+ *  - LittleFS monté une seule fois, taille des fichiers mémorisée, descripteur d'ajout
+ *    des logs conservé ouvert et écrit en flash par FileLittleFS::syncAll()
+ *  - Enregistrements binaires écrits dans une copie temporaire puis renommés, numérotés ;
+ *    au démarrage reprise de la copie valide la plus récente après une coupure
+ *  - Journal circulaire segmenté (log_store.h) à la place de logs.txt supprimé une fois
+ *    plein : enregistrements numérotés, les derniers segments sont toujours conservés.
+ *    homecontrol/logs_get relit à partir du numéro reçu, numéro suivant publié sur
+ *    homecontrol/logs_seq
+ *  - Evénements du journal enregistrés en binaire (log_event.h, 8 octets : date, code,
+ *    dispositif, valeur) ; le texte n'est produit qu'à la lecture par homecontrol/logs_get
+ *  - Table triée des topics d'abonnement (topic_table.h) : une fonction par topic,
+ *    recherche dichotomique à la réception, même table pour les abonnements
+ *  - Messages MQTT reçus traités sur place (vue sur le tampon de PubSubClient) : plus de
+ *    String construite caractère par caractère, commandes numériques lues sans copie
+ *  - File d'attente des publications MQTT (mqtt_queue.h) vidée par loop() : appel
+ *    immédiat depuis les callbacks et temporisateurs, topics d'état réduits à leur
+ *    dernière valeur, compteurs sur homecontrol/mqtt_stats
+ *  - Reconnexion WiFi / MQTT par un automate non bloquant (net_link.h) appelé par loop() :
+ *    délai exponentiel avec tirage aléatoire entre tentatives, abonnements puis
+ *    republication de l'état, compteurs sur homecontrol/net_stats
+ *  - Connexion WiFi directe au point d'accès mémorisé (BSSID, canal) et réutilisation
+ *    du bail DHCP après un redémarrage logiciel (wifi_cache.h), recherche complète
+ *    en cas d'échec ; durée de connexion enregistrée dans les logs au démarrage
+ *  - Environnement PlatformIO native : couche d'abstraction native/ (Arduino, FreeRTOS,
+ *    LittleFS, PubSubClient, ESP32Time, LCD...) pour exécuter la logique sur Linux
  */
 
 #include "main.h"
@@ -209,10 +267,11 @@ AsyncWebServer server(80);
 
 void recvMsg(uint8_t* data, size_t len) {
   WebSerial.println("Received Data...");
-  String d = "";
-  for (int i = 0; i < len; i++) {
-    d += char(data[i]);
-  }
+  // Copie bornée sur la pile, sans allocation
+  char d[128];
+  len = min(len, sizeof(d) - 1);
+  memcpy(d, data, len);
+  d[len] = '\0';
   WebSerial.println(d);
 }
 #endif
@@ -318,12 +377,8 @@ const char* bootRaison() {
  *         de manipulation des paramètres 
  */
 FileLittleFS* initParam(boolean force) {
-  auto* fileParam = new FileLittleFS(PARAM_FILE_NAME);
-  if (!FileLittleFS::exist(PARAM_FILE_NAME) || force) {
-    fileParam->writeFile(PARAM, "w");
-  } 
-  cParam = new Param(fileParam->readFile().c_str());
-  fileParam->close();
+  cParam = new Param(PARAM);
+  auto* fileParam = openParam(PARAM_FILE_NAME, PARAM_TEXT_FILE_NAME, cParam, force);
 #ifdef DEBUG_OUTPUT
 //  cParam->print();
 //  cParam->printStrParam();
@@ -339,12 +394,8 @@ FileLittleFS* initParam(boolean force) {
  *         des tempos
  */
 FileLittleFS* initDlyParam(boolean force) {
-  auto* fileDlyParam = new FileLittleFS(DLY_PARAM_FILE_NAME);
-  if (!FileLittleFS::exist(DLY_PARAM_FILE_NAME) || force) {
-    fileDlyParam->writeFile(DEFAUT_DELAY_PARAM, "w");
-  }
-  cDlyParam = new SimpleParam(fileDlyParam->readFile().c_str(), ":", N_DLY_PARAM);
-  fileDlyParam->close();
+  cDlyParam = new SimpleParam(dlyParamSchema);
+  auto* fileDlyParam = openParam(DLY_PARAM_FILE_NAME, DLY_PARAM_TEXT_FILE_NAME, cDlyParam, force);
   // cDlyParam->print();
 #ifdef DEBUG_OUTPUT
   cDlyParam->print();
@@ -360,12 +411,9 @@ FileLittleFS* initDlyParam(boolean force) {
  *         des éléments de persistance.
  */
 FileLittleFS* initPersitantFileDevice(boolean force) {
-  auto* filePersistantParam = new FileLittleFS(FILE_PERSISTANT_DEVICE);
-  if (!FileLittleFS::exist(FILE_PERSISTANT_DEVICE) || force) {
-    filePersistantParam->writeFile(PERSISTANT, "w");
-  }
-  cPersistantParam = new SimpleParam(filePersistantParam->readFile().c_str(), ":", N_PERSISTANT_PARAM);
-  filePersistantParam->close();
+  cPersistantParam = new SimpleParam(persistantParamSchema);
+  auto* filePersistantParam = openParam(FILE_PERSISTANT_DEVICE, PERSISTANT_TEXT_FILE_NAME,
+                                        cPersistantParam, force);
 #ifdef DEBUG_OUTPUT
   cPersistantParam->print();
 #endif
@@ -380,12 +428,10 @@ FileLittleFS* initPersitantFileDevice(boolean force) {
  *         des éléments de persistance.
  */
 FileLittleFS* initGlobalScheduledParam(boolean force) {
-  auto* fileGlobalScheduledParam = new FileLittleFS(GLOBAL_SCHEDULED_PARAM_FILE_NAME);
-  if (!FileLittleFS::exist(GLOBAL_SCHEDULED_PARAM_FILE_NAME) || force) {
-    fileGlobalScheduledParam->writeFile(DEFAUT_GLOBAL_SCHEDULED_PARAM, "w");
-  }
-  cGlobalScheduledParam = new SimpleParam(fileGlobalScheduledParam->readFile().c_str(), ":", MAX_ITEMS_GLOBAL_SCHEDULED_PARAM);
-  fileGlobalScheduledParam->close();
+  cGlobalScheduledParam = new SimpleParam(globalScheduledParamSchema);
+  auto* fileGlobalScheduledParam = openParam(GLOBAL_SCHEDULED_PARAM_FILE_NAME,
+                                             GLOBAL_SCHEDULED_PARAM_TEXT_FILE_NAME,
+                                             cGlobalScheduledParam, force);
 #ifdef DEBUG_OUTPUT
   cGlobalScheduledParam->print();
 #endif
@@ -408,17 +454,29 @@ FileLittleFS* initGlobalScheduledParam(boolean force) {
 // }
 
 /**
- * @brief Instancie fileLogs.
- * @param force : initialise avec les valeurs par défaut
- * @return fileLogs*
+ * @brief Instancie le journal circulaire.
+ *        L'ancien fichier texte LOG_FILE_NAME est repris ligne par ligne puis supprimé.
+ * @param force : efface le journal
+ * @return LogStore*
  */
-FileLittleFS* initLogs(boolean force) {
-  auto* fileLogs = new FileLittleFS(LOG_FILE_NAME);
-  if (!FileLittleFS::exist(LOG_FILE_NAME) || force) {
-    fileLogs->writeFile(DEFAULT_DATE, "w");
-    fileLogs->close();
+LogStore* initLogs(boolean force) {
+  auto* logs = new LogStore();
+  logs->begin(force);
+  if (FileLittleFS::exist(LOG_FILE_NAME)) {
+    FileLittleFS oldLogs(LOG_FILE_NAME);
+    String text = oldLogs.readFile();
+    int i = 0;
+    while (i < (int)text.length()) {
+      int end = text.indexOf('\n', i);
+      if (end < 0)
+        end = text.length();
+      if (end > i)
+        logs->append(text.c_str() + i, end - i);
+      i = end + 1;
+    }
+    oldLogs.rmFile();
   }
-  return fileLogs;
+  return logs;
 }
 
 /**
@@ -453,13 +511,16 @@ void initTime(boolean wifiConnected) {
 
 const char* getDate() {
   static char date[80];
+  // Heure sans décalage avant initTime() (logs de la lecture des paramètres)
+  static ESP32Time utc(0);
+  ESP32Time* clock = rtc != NULL ? rtc : &utc;
   sprintf(date, "%02d/%02d/%4d %02d:%02d:%02d",
-    rtc->getDay(),
-    rtc->getMonth() + 1,
-    rtc->getYear(),
-    rtc->getHour(true), // true -> format 24H
-    rtc->getMinute(),
-    rtc->getSecond());
+    clock->getDay(),
+    clock->getMonth() + 1,
+    clock->getYear(),
+    clock->getHour(true), // true -> format 24H
+    clock->getMinute(),
+    clock->getSecond());
   return date;
 }
 
@@ -477,29 +538,16 @@ void setDate(char* date) {
  * Initialise les GPIO utilisés par l'automate.
  * 
  * @details
- * - Pour la carte ES32A08, initialise les GPIO pour les registres à décalage 74HC595 et 74HC165
+ * - Pour la carte ES32A08, initialise les GPIO ou les bus SPI pour les registres à décalage 74HC595 et 74HC165
  * - Pour les autres cartes, initialise les GPIO pour les relais et entrées digitales
  */
 void initGpio() {
 #ifdef ES32A08
-  pinMode(POWER_LED, OUTPUT);
-  digitalWrite(POWER_LED, LOW);
-
-  pinMode(CLK_165, OUTPUT);
-  digitalWrite(CLK_165, LOW);
-  pinMode(LOAD_165, OUTPUT);
-  digitalWrite(LOAD_165, HIGH);
-  pinMode(DATA_165, INPUT);
-
-  pinMode(CLOCK_955, OUTPUT);
-  pinMode(LATCH_955, OUTPUT);
-  digitalWrite(NOE_955, 1);
-  pinMode(NOE_955, OUTPUT);
-
-  // Mettre les registres à décalage à zéro  
-  clear74HC595();
-  digitalWrite(NOE_955, 0);
-  pinMode(DATA_955, OUTPUT);
+  // Broches ou bus SPI selon le pilote choisi (IO_BACKEND_xxx dans const.h)
+  // Les registres à décalage sont mis à zéro
+  initShiftRegisters();
+  // Premier instantané des entrées (lecture du contact porte dans setup)
+  sampleInputs();
 
 #else  
   pinMode(O_TRANSFO, OUTPUT);
@@ -565,7 +613,51 @@ void publishGpio() {
       vmcMode,
       gpioReadPac());
       // Serial.println(tabValue);
-    mqttClient.publish(TOPIC_GPIO, tabValue);
+    mqttPublish(TOPIC_GPIO, tabValue);
+}
+
+/**
+ * @brief Ecriture inconditionnelle d'un événement
+ *        Aucune mise en forme : le texte est produit à la lecture (formatEvent).
+ * 
+ * @param code EV_*
+ * @param device dispositif
+ * @param value valeur associée au code
+ * @param text message (EV_TEXT)
+ */
+void eventWrite(uint8_t code, uint8_t device, uint16_t value, const char* text) {
+  if (flashThrottle())
+    return;
+  // Heure sans décalage avant initTime() (logs de la lecture des paramètres)
+  uint32_t time = rtc != NULL ? rtc->getLocalEpoch() : ESP32Time(0).getEpoch();
+  uint8_t buffer[LOG_MAX_RECORD];
+  // Logs supprimés depuis la dernière écriture (budget d'écriture flash dépassé)
+  uint32_t throttled = flashThrottledTake();
+  if (throttled) {
+    LogEvent event = { time, EV_THROTTLED, 0, (uint16_t)min(throttled, (uint32_t)UINT16_MAX) };
+    logStore->append(&event, sizeof(LogEvent), LOG_TYPE_EVENT);
+  }
+  LogEvent event = { time, code, device, value };
+  memcpy(buffer, &event, sizeof(LogEvent));
+  size_t size = sizeof(LogEvent);
+  if (text) {
+    size_t length = min(strlen(text), sizeof(buffer) - sizeof(LogEvent));
+    memcpy(buffer + size, text, length);
+    size += length;
+  }
+  logStore->append(buffer, size, LOG_TYPE_EVENT);
+}
+
+/**
+ * @brief Ecriture conditionnelle d'un événement
+ * 
+ * @param code EV_*
+ * @param device dispositif
+ * @param value valeur associée au code
+ */
+void writeEvent(uint8_t code, uint8_t device, uint16_t value) {
+  if (cDlyParam->get(LOG_STATUS))
+    eventWrite(code, device, value, NULL);
 }
 
 /**
@@ -574,11 +666,7 @@ void publishGpio() {
  * @param log  message de log
  */
 void logsWrite(const char* log) {
-  char buffer[80];
-  if (fileLogs->fileSize() > MAX_LOG_SIZE)
-    fileLogs->rmFile(); // Supprime le fichier si trop gros
-  sprintf(buffer, "%s - %s\n", getDate(), log);
-  fileLogs->writeFile(buffer, "a");
+  eventWrite(EV_TEXT, 0, 0, log);
 }
 
 /**
@@ -591,6 +679,17 @@ void writeLogs(const char* log) {
     logsWrite(log);
 }
 
+/**
+ * @brief Publie une ligne du journal sur TOPIC_READ_LOGS (LogStore::read)
+ */
+void publishLog(uint32_t, uint8_t type, const uint8_t* data, size_t size, void*) {
+  char buffer[LOG_MAX_RECORD + 32];
+  int n = formatEvent(type, data, size, buffer, sizeof(buffer) - 1);
+  buffer[n] = '\n';
+  buffer[n + 1] = '\0';
+  mqttClient.publish(TOPIC_READ_LOGS, buffer);
+}
+
 #ifdef WIFI_MANAGER
 void initWifiStation() {
   WiFi.setHostname(HOSTNAME);
@@ -621,8 +720,13 @@ boolean initWifiStation(boolean flagDisplay) {
   int i=0;
   WiFiClass::setHostname(hostname);  
   WiFi.mode(WIFI_STA);
-  WiFi.begin(ssid, password);
-  while (WiFi.waitForConnectResult() != WL_CONNECTED) {
+  // Point d'accès mémorisé : connexion directe, recherche complète en cas d'échec
+  boolean direct = wifiCacheBegin(ssid, password);
+  while ((direct ? WiFi.waitForConnectResult(WIFI_DIRECT_TIMEOUT) : WiFi.waitForConnectResult()) != WL_CONNECTED) {
+    if (wifiCacheFailed()) {
+      direct = wifiCacheBegin(ssid, password);
+      continue;
+    }
 #ifndef IO_DEBUG    
 //  backLightOff();
 #endif
@@ -633,6 +737,7 @@ boolean initWifiStation(boolean flagDisplay) {
     if (++i > 3)
       return false;
   }
+  wifiCacheConnected();
   WiFi.setAutoReconnect(true);
   WiFi.persistent(true);
   WiFi.setTxPower(WIFI_POWER_19_5dBm);
@@ -650,13 +755,14 @@ boolean initWifiStation(boolean flagDisplay) {
 #endif
 
 /**
- * @brief Initialisation du client MQTT
+ * @brief Initialisation du client MQTT (setup)
  * 
  * @details
  * - Configure le client MQTT avec le serveur, le port et les callbacks.
  * - Tente de se connecter au serveur MQTT.
  * - En cas d'échec, réessaie plusieurs fois avec un délai.
  * - Abonne aux topics nécessaires.
+ * Les reconnexions sont ensuite assurées par loop() (net_link.h).
  * 
  * @return true si la connexion est établie, false sinon.
  */
@@ -668,6 +774,8 @@ boolean initMQTTClient(boolean flagDisplay) {
   // Fixé dans PubSubClient.h
   ///mqttClient.setBufferSize(MQTT_MAX_BUFFER_SIZE);
   mqttClient.setCallback(PubSubCallback);
+  // Tentative de connexion bornée (automate de reconnexion de loop())
+  mqttClient.setSocketTimeout(NET_SOCKET_TIMEOUT);
   // Pour un même courtier les clients doivent avoir un id différent
   String clientId = "ESP32Client-";
   clientId += String(random(0xffff), HEX);
@@ -680,36 +788,30 @@ boolean initMQTTClient(boolean flagDisplay) {
   }
   if (flagDisplay)
     Serial.println("MQTT client connected");
-  // Déclare Pub/Sub topics
-  mqttClient.subscribe(TOPIC_GET_PARAM);
-  mqttClient.subscribe(TOPIC_WRITE_PARAM);
-  mqttClient.subscribe(TOPIC_GET_DLY_PARAM);
-  mqttClient.subscribe(TOPIC_WRITE_DLY_PARAM);
-  mqttClient.subscribe(TOPIC_GET_GPIO);
-
-  mqttClient.subscribe(TOPIC_CMD_ARROSAGE);
-  mqttClient.subscribe(TOPIC_CMD_IRRIGATION);
-  mqttClient.subscribe(TOPIC_CMD_CUISINE);
-  mqttClient.subscribe(TOPIC_CMD_VMC);
-  mqttClient.subscribe(TOPIC_CMD_VANNE_EST);
-  mqttClient.subscribe(TOPIC_CMD_PAC);
-  mqttClient.subscribe(TOPIC_CMD_REAMORCER);
-
-  mqttClient.subscribe(TOPIC_LOGS_GET);
-  mqttClient.subscribe(TOPIC_CLEAR_LOGS);
-  mqttClient.subscribe(TOPIC_REBOOT);
-  mqttClient.subscribe(TOPIC_GET_VERSION);
-  mqttClient.subscribe(TOPIC_WATCH_DOG_OFF);
-
-  mqttClient.subscribe(TOPIC_GET_GLOBAL_SCHED);
-  mqttClient.subscribe(TOPIC_WRITE_GLOBAL_SCHED);
-  mqttClient.subscribe(TOPIC_MQTT_GET_STATUS);
-  mqttClient.subscribe(TOPIC_APP_CONNECT);
-
-//  mqttClient.subscribe(TOPIC_MQTT_TEST);
+  // Déclare Pub/Sub topics (table des traitements des messages reçus)
+  subscribeTopics();
   return true;
 }
 
+/**
+ * @brief Reconnexion au courtier : état courant republié
+ *        (l'application et HA ont pu manquer des changements)
+ */
+static void netResync() {
+  CtrlGuard guard;
+  // WiFi absent au démarrage
+  if (!wifiConnected) {
+    wifiConnected = true;
+    initOTA();
+  }
+  publishStatus();
+  publishNextEvent();
+}
+
+static const NetLinkConfig netConfig = {
+  ssid, password, mqttUser, mqttPassword, subscribeTopics, netResync
+};
+
 
 /**
  * @brief Point d'entrée du programme
@@ -732,12 +834,14 @@ void setup() {
   int val = O_VMC;
   for (int i=0; i < 8; i++) {
     on(val);
+    ioFlush();
     val <<= 1;
     delay(1000);
   }
   for (int i=0; i < 8; i++) {
     val >>= 1;
     off(val);
+    ioFlush();
     delay(1000);
   }
   for (;;) {
@@ -765,18 +869,30 @@ void setup() {
   lcdPrintString(buffer, 0, 0, true);
   delay(500);
   // fileDateParam = initDateParam(false);
-  fileLogs = initLogs(FORCE_LOGS);
+  // Avant toute écriture en mémoire flash
+  flashStatsInit();
+  logStore = initLogs(FORCE_LOGS);
   fileParam = initParam(FORCE_INIT_PARAM);
   fileDlyParam = initDlyParam(FORCE_INIT_DLY_PARAM);
   fileGlobalScheduledParam = initGlobalScheduledParam(FORCE_GLOBAL_SCHEDULED_PARAM);
   filePersistantParam = initPersitantFileDevice(FORCE_PERSISTANT_PARAM);
   
+  wifiCacheInit();
   if (wifiConnected = initWifiStation(true)) {
-    sprintf(rssi_buffer, "RSSI:%ld", WiFi.RSSI());
+    snprintf(rssi_buffer, sizeof(rssi_buffer), "RSSI:%d", (int)WiFi.RSSI());
     mqttConnect = initMQTTClient(true);
   }
+  // Reconnexions assurées par loop()
+  netLinkBegin(mqttClient, netConfig, mqttConnect);
 
   initTime(wifiConnected);
+  // Table des actions programmées, les événements de la minute courante restent à exécuter.
+  // Après un redémarrage logiciel (reboot de 01:01, OTA, watchdog) les événements
+  // manqués depuis la dernière minute évaluée sont rattrapés par schedule()
+  cSchedule = new Schedule();
+  if (!cSchedule->restore(rtc->getEpoch()))
+    cSchedule->seek(rtc->getHour(true) * 60 + rtc->getMinute() - 1);
+  cSchedule->compile(cParam);
   initRotary();
   lcdPrintString(getDate(), 3, 0, true);
   Serial.println(getDate());
@@ -787,6 +903,15 @@ void setup() {
   // Temps de lecture des infos
   delay(1000);
   logsWrite(bootRaison());
+  if (wifiConnected) {
+    char wifiBuffer[32];
+    WifiCacheStats wifiStats;
+    wifiCacheStatsTake(&wifiStats);
+    snprintf(wifiBuffer, sizeof(wifiBuffer), "WiFi %lu ms %s", (unsigned long)wifiStats.bootConnect,
+             wifiStats.lastDirect ? "direct" : "recherche");
+    Serial.println(wifiBuffer);
+    logsWrite(wifiBuffer);
+  }
   // Serial.println(strlen(cParam->getStr()));
   // cParam->print();
 
@@ -798,7 +923,7 @@ void setup() {
 
   //----------------------------------------- Init monostables ----------------------------------------------
   // ****** Pas d'accès fichier dans un monostable (kernel panic) ******
-  // ****** Pas d'envois repété de messages MQTT (kernel panic)   ******
+  // ****** Messages MQTT par mqttPublish() (file d'attente)      ******
   // Monostable durée max lance arrosage
   tache_t_watering = t_cree(monoWatering, cvrtic(cDlyParam->get(TIME_WATERING) * 1000));
   // Monostable durée remplissage réservoir
@@ -840,12 +965,12 @@ void setup() {
   if (!cPersistantParam->get(PAC)) {
     off(O_PAC);
     pacStatus = PAC_STATUS_OFF;
-    mqttClient.publish(TOPIC_STATUS_PAC, S_OFF);     
+    mqttPublish(TOPIC_STATUS_PAC, S_OFF);     
   }
   else {
     on(O_PAC);
     pacStatus = PAC_STATUS_ON;
-    mqttClient.publish(TOPIC_STATUS_PAC, S_ON);      
+    mqttPublish(TOPIC_STATUS_PAC, S_ON);      
     t_start(tache_t_monoPacOn);
   }
 #endif  
@@ -858,8 +983,10 @@ void setup() {
 #endif  
 #ifdef PERSISTANT_VANNE_EST
   if (cPersistantParam->get(VANNE_EST)) {
+    ioBegin();
     on(O_TRANSFO);
     on(O_EV_EST);
+    ioCommit();
   }
 #endif  
 
@@ -885,6 +1012,14 @@ void setup() {
   addDevices();
   Serial.println("Alexa command");
 #endif  
+  // Etat des relais restauré pendant setup
+  ioFlush();
+  // Enregistrements des paramètres regroupés à partir d'ici
+  persistInit();
+#ifdef SCAN_TASK
+  // Entrées, logique locale et sorties à période fixe sur SCAN_TASK_CORE
+  initScanTask();
+#endif
   Serial.println("End setup");
 }
 
@@ -896,7 +1031,7 @@ void setup() {
  * La carte esp01s déportée est alimentée par la mise sous
  * temsion de la VMC et necessite quelques secondes pour accepter les messages MQTT
  * ACCES AUX FICHIERS NON AUTORISES
- * UN SEUL MESSAGE MQTT A LA FOIS (débordement de la pile ISR)
+ * Messages MQTT par la file d'attente uniquement (mqttPublish)
  */
 void monoCmdVmcBoard(TimerHandle_t xTimer) {
 #ifdef DEBUG_OUTPUT
@@ -904,7 +1039,7 @@ void monoCmdVmcBoard(TimerHandle_t xTimer) {
 #endif
   // t_stop(tache_t_cmdVmcBoard);
   // Envoi de la commande vers la carte déportée
-  mqttClient.publish(VMC_BOARD_ACTION, S_ON);
+  mqttPublish(VMC_BOARD_ACTION, S_ON);
   if (!vmcFast)
     t_start(tache_t_cmdVmcBoardOff);  
 }
@@ -915,7 +1050,7 @@ void monoCmdVmcBoardOff(TimerHandle_t xTimer) {
 #endif
   // Envoi de la commande vers la carte déportée
   if (!vmcFast)
-    mqttClient.publish(VMC_BOARD_ACTION, S_OFF);
+    mqttPublish(VMC_BOARD_ACTION, S_OFF);
 }
 
 /*
@@ -927,7 +1062,7 @@ void monoPacOff(TimerHandle_t xTimer) {
   print("Mono Arret PAC\n", OUTPUT_PRINT);
 #endif
   off(O_PAC);
-  mqttClient.publish(TOPIC_STATUS_PAC, S_OFF);
+  mqttPublish(TOPIC_STATUS_PAC, S_OFF);
   irSendPacOff = false;
 }
 
@@ -937,7 +1072,7 @@ void monoPacOff(TimerHandle_t xTimer) {
  * @param xTimer 
  */
 void monoPacOn(TimerHandle_t xTimer) {
-  mqttClient.publish(TOPIC_PAC_IR_ON, "");
+  mqttPublish(TOPIC_PAC_IR_ON, "");
 }
 
 /**
@@ -967,7 +1102,7 @@ void monoSurpressorFilling(TimerHandle_t xTimer) {
   if (!startSupressorFilling2) {
     // Echec première tentative
     // Possibilité de reprise par bouton réarmement local ou à distance
-    mqttClient.publish(TOPIC_DEFAUT_SUPRESSOR, "on");
+    mqttPublish(TOPIC_DEFAUT_SUPRESSOR, "on");
     erreurSupresseur = true;
 #ifdef DEBUG_OUTPUT
     print("TOPIC_GPIO_DEFAUT_SUPRESSEUR  on\n", OUTPUT_PRINT);
@@ -978,7 +1113,7 @@ void monoSurpressorFilling(TimerHandle_t xTimer) {
     // Problème sur le circuit hydraulique pompe surpresseur
     // Pas de troisième tentative, résolution du problème
     // par intervention physique
-    mqttClient.publish(TOPIC_DEFAUT_SUPRESSOR, "on2");
+    mqttPublish(TOPIC_DEFAUT_SUPRESSOR, "on2");
     erreurPompe = true;
 #ifdef DEBUG_OUTPUT
     print("TOPIC_GPIO_DEFAUT_SUPRESSEUR_N2  on\n", OUTPUT_PRINT);
@@ -995,8 +1130,10 @@ void monoCmdEvEst(TimerHandle_t xTimer) {
 #ifdef DEBUG_OUTPUT
   print("monoCmdEvEst\n", OUTPUT_PRINT);
 #endif
+  ioBegin();
   off(O_TRANSFO);
   off(O_EV_EST);
+  ioCommit();
 }
 
 /**
@@ -1029,7 +1166,7 @@ void monoDefaultDisplay(TimerHandle_t xTimer) {
  * @param xTimer 
  */   
  void monoOffCircuit2(TimerHandle_t xTimer) {
-  mqttClient.publish(SUB_GPIO0_ACTION, "off");
+  mqttPublish(SUB_GPIO0_ACTION, "off");
 }
 
 /**
@@ -1066,7 +1203,7 @@ void monoSurpressorSecurity(TimerHandle_t xTimer) {
       n_supressorFillingInTime >= MAX_SUPRESSOR_FILLING_IN_TIME ) {
     off(O_POMPE);
     cDlyParam->set(SUPRESSOR_EN, 0);
-    mqttClient.publish(TOPIC_SUPRESSOR_SECURITY, "on");
+    mqttPublish(TOPIC_SUPRESSOR_SECURITY, "on");
     supressorFillingSecurity = true;
     monoSurpressorSecurityStarted = false;
   }
@@ -1084,7 +1221,7 @@ void onVanneEst() {
   t_start(tache_t_monoDebit);
   // Logique inversée, utilisé pour signaler commande vanne EST
   cmdVanneEst = 0;
-  writeLogs("Irrigation façade SUD");
+  writeEvent(EV_VANNE_EST_ON);
 }
 
 /**
@@ -1094,230 +1231,304 @@ void onVanneEst() {
 void offVanneEst() {
   // Logique inversée
   cmdVanneEst = 1;
+  ioBegin();
   off(O_TRANSFO);
   off(O_EV_EST);
+  ioCommit();
   t_stop(tache_t_monoDebit);
-  writeLogs("Fin irrigation façade SUD");
+  writeEvent(EV_VANNE_EST_OFF);
 }
 
-//--------------------------------------------------------------------------------------------
+// Plages modifiées par une action programmée (compte de jours du circuit 2),
+// enregistrées par schedule() après libération de CtrlGuard
+static boolean paramSavePending;
+
 /**
- * @brief Exécuté toutes les minutes
- *        Exécute les actions temporelles programmées dans param
- * Appelé par loop (on ne peut pas utiliser les timers RTOS (schedule accède aux fichiers))
+ * @brief Mise sous tension programmée d'un dispositif
+ * @param deviceId POWER_COOK, IRRIGATION, VANNE_EST, PAC, VMC
+ * @param enable niveau d'activation de la plage (2 = VMC rapide)
  */
-void schedule() {
-  // static boolean vmcBoardOn = false;
-  // static boolean vmcFastR = false;
-  // static boolean onVmcExec = false;
-  static boolean flagJours = false;
-
-  ItemParam item;
-
-#ifdef DEBUG_HEAP
-  Serial.printf("Free heap %x : min free heap %x\n", ESP.getFreeHeap(), ESP.getMinFreeHeap());
-#endif
-#ifndef TIME_SIMULATOR
-  int h = rtc->getHour(true); // true -> format 24H
-  int m = rtc->getMinute();
-  // Mise à jour du jours courant (persistant) utilisé par circuit secondaire irrigation
-  if (h == 0 && !flagJours) {
-    flagJours = true;
-    joursCircuit2++;
-    item = cParam->get(IRRIGATION, 0);
-    item.MMax = joursCircuit2;
-    cParam->set(IRRIGATION, 0, item);
-    cParam->updateStringParam(cParam->getStr());
-    fileParam->writeFile(cParam->getStr(), "w");
-  }
-  if (h == 1 && flagJours) {
-    flagJours = false;
-  }
-#else  
-  if (m++ == 60) {
-    m = 0;
-    if (h++ == 24)
-      h = 0;
-  }
-  // Serial.println(ESP.getFreeHeap());
-  // Serial.println(ESP.getHeapSize());
-  Serial.printf("%02d:%02d\r", h, m);
-#endif
-  // Reboot automatique à 01:01 pour éviter un bug de l'ESP32 qui bloque le programme
-  if (h == 1 && m == 1)
-    ESP.restart();
-
-  for (int deviceId = 0; deviceId < N_DEVICES; deviceId++) {
-    // Programmation autorisée pour ce device ?
-    if (!cGlobalScheduledParam->get(deviceId)) {
-      continue;
-    }
-    for (int timeSet = 0; timeSet < N_PLAGES; timeSet++) {
-      item = cParam->get(deviceId, timeSet);
-      // -----------------------------------------------------------
-      //---------------- Mises sous tension ------------------------
-      // -----------------------------------------------------------
-      if (item.enable != 0 && item.HMin == h && item.MMin == m) {
-#ifdef DEBUG_OUTPUT_SCHEDULE_
-        Serial.printf("%02d:%02d\n", h, m);
-        item.print();
-#endif
-        switch (deviceId) {
-          case POWER_COOK:
-          #ifdef DEBUG_OUTPUT_SCHEDULE
-          Serial.printf("%02d:%02d off(O_FOUR)\n", h, m);
+void scheduledOn(int deviceId, int enable) {
+  switch (deviceId) {
+  case POWER_COOK:
+#ifdef DEBUG_OUTPUT_SCHEDULE
+    Serial.println("on(O_FOUR)");
 #endif
 #ifdef PERSISTANT_POWER_COOK            
-          cPersistantParam->set(POWER_COOK, 0);
-          filePersistantParam->writeFile(cPersistantParam->getStr(), "w");
+    cPersistantParam->set(POWER_COOK, 0);
+    persistParam(filePersistantParam, cPersistantParam);
 #endif
-          on(O_FOUR);
-          // Mise à jour de l'IHM déportée
-          mqttClient.publish(TOPIC_STATUS_CUISINE, "on"); 
-          break;
+    on(O_FOUR);
+    // Mise à jour de l'IHM déportée
+    mqttPublish(TOPIC_STATUS_CUISINE, "on"); 
+    break;
 
-        case IRRIGATION: {
+  case IRRIGATION: {
 #ifdef DEBUG_OUTPUT_SCHEDULE
-            Serial.printf("%02d:%02d startTankFilling..\n", h, m);
+      Serial.println("startTankFilling..");
 #endif    
-            startTankFilling();
-            // Gestion de la vanne du circuit 2 
-            // Circuit 2 est une vanne intallée sur le circuit d'arrosage des tomates
-            // et permet un arrossage non journalier
-            // La périodicité en jour est mémorisée le champ libre item.HMax
-            ItemParam item = cParam->get(IRRIGATION, 0);
-            // Serial.printf("itemJ.HMax=%d, jours=%d\n", itemJ.HMax, jours);
-            // Gestion de la commande déportée de la vanne gérant la période d'irrigation
-            // non journalière
-            if (item.HMax >= joursCircuit2) {
-              mqttClient.publish(SUB_GPIO0_ACTION, "on");
-              // La coupure est programmée dans le dispositif distant
-              // Reset du compte de jours
-              joursCircuit2 = 0;
-              // Mémorisation
-              item.MMax = 0;
-              cParam->set(IRRIGATION, 0, item);
-              // itemJ.print();
-              cParam->updateStringParam(cParam->getStr());
-              // cParam->print();
-              fileParam->writeFile(cParam->getStr(), "w");
-            }
-          }
-          break;
-
-        case VANNE_EST:
+      startTankFilling();
+      // Gestion de la vanne du circuit 2 
+      // Circuit 2 est une vanne intallée sur le circuit d'arrosage des tomates
+      // et permet un arrossage non journalier
+      // La périodicité en jour est mémorisée le champ libre item.HMax
+      ItemParam item = cParam->get(IRRIGATION, 0);
+      // Gestion de la commande déportée de la vanne gérant la période d'irrigation
+      // non journalière
+      if (item.HMax >= joursCircuit2) {
+        mqttPublish(SUB_GPIO0_ACTION, "on");
+        // La coupure est programmée dans le dispositif distant
+        // Reset du compte de jours
+        joursCircuit2 = 0;
+        // Mémorisation, enregistrée par schedule() hors CtrlGuard
+        item.MMax = 0;
+        cParam->set(IRRIGATION, 0, item);
+        paramSavePending = true;
+      }
+    }
+    break;
+
+  case VANNE_EST:
 #ifdef DEBUG_OUTPUT_SCHEDULE
-          Serial.printf("%02d:%02d on(O_EV_EST)\n", h, m);
+    Serial.println("on(O_EV_EST)");
 #endif      
-          // La durée d'ouverture de la vanne est gérée par un monostable
+    // La durée d'ouverture de la vanne est gérée par un monostable
 #ifdef PERSISTANT_VANNE_EST
-          cPersistantParam->set(VANNE_EST, 1);
-          filePersistantParam->writeFile(cPersistantParam->getStr(), "w");
+    cPersistantParam->set(VANNE_EST, 1);
+    persistParam(filePersistantParam, cPersistantParam);
 #endif          
-          onVanneEst();
-          break;
+    onVanneEst();
+    break;
 
-        case PAC:
-          // Serial.printf("%02d:%02d off(O_PAC)\n", h, m);
-          on(O_PAC);
+  case PAC:
+    on(O_PAC);
 #ifdef PERSISTANT_PAC       
-          // Attention pas de timer
-          cPersistantParam->set(PAC, 1);
-          filePersistantParam->writeFile(cPersistantParam->getStr(), "w");
+    // Attention pas de timer
+    cPersistantParam->set(PAC, 1);
+    persistParam(filePersistantParam, cPersistantParam);
 #endif           
-          // Envoi d'une commande IR retardée
-          t_start(tache_t_monoPacOn);
-          break;
+    // Envoi d'une commande IR retardée
+    t_start(tache_t_monoPacOn);
+    break;
 
-        case VMC:
+  case VMC:
 #ifdef DEBUG_OUTPUT_SCHEDULE
-          Serial.printf("%02d:%02d, vmcMode=%d \n", h, m, vmcMode);
-#endif
-          switch (vmcMode) {
-          case VMC_STOP:
-          case VMC_ON_FAST:
-          case VMC_ON: break;
-          default:
-              onVmc = item.enable;
-              setVmc(CMD_VMC_PROG);
-            break;
-          }
-          break;
-        default: ;
-        }
-      }
-      // -----------------------------------------------------------
-      // --------------- Mises hors tension ------------------------
-      // -----------------------------------------------------------
-      if (item.enable != 0 && item.HMax == h && item.MMax == m) {
-#ifdef DEBUG_OUTPUT_
-        Serial.printf("%02d:%02d\n", h, m);
-        item.print();
+    Serial.printf("vmcMode=%d \n", vmcMode);
 #endif
-        switch (deviceId) {
+    switch (vmcMode) {
+    case VMC_STOP:
+    case VMC_ON_FAST:
+    case VMC_ON: break;
+    default:
+      onVmc = enable;
+      setVmc(CMD_VMC_PROG);
+      break;
+    }
+    break;
+  default: ;
+  }
+}
 
-        case POWER_COOK:
+/**
+ * @brief Mise hors tension programmée d'un dispositif
+ * @param deviceId POWER_COOK, VANNE_EST, PAC, VMC
+ */
+void scheduledOff(int deviceId) {
+  switch (deviceId) {
+  case POWER_COOK:
 #ifdef DEBUG_OUTPUT_SCHEDULE
-          Serial.printf("%02d:%02d off(O_FOUR)\n", h, m);
+    Serial.println("off(O_FOUR)");
 #endif
 #ifdef PERSISTANT_POWER_COOK            
-          cPersistantParam->set(POWER_COOK, 0);
-          filePersistantParam->writeFile(cPersistantParam->getStr(), "w");
+    cPersistantParam->set(POWER_COOK, 0);
+    persistParam(filePersistantParam, cPersistantParam);
 #endif
-          off(O_FOUR);
-          // Mise à jour de l'IHM déportée
-          mqttClient.publish(TOPIC_STATUS_CUISINE, "off"); 
-          break;
-        // L a durée du remplissage du réservoir gérée par un monostable
-        case IRRIGATION:
-          break;
-
-        case VANNE_EST:
+    off(O_FOUR);
+    // Mise à jour de l'IHM déportée
+    mqttPublish(TOPIC_STATUS_CUISINE, "off"); 
+    break;
+  // La durée du remplissage du réservoir gérée par un monostable
+  case IRRIGATION:
+    break;
+
+  case VANNE_EST:
 #ifdef DEBUG_OUTPUT_SCHEDULE
-          Serial.printf("%02d:%02d off(O_EV_EST)\n", h, m);
+    Serial.println("off(O_EV_EST)");
 #endif
 #ifdef PERSISTANT_VANNE_EST
-          cPersistantParam->set(VANNE_EST, 0);
-          filePersistantParam->writeFile(cPersistantParam->getStr(), "w");
+    cPersistantParam->set(VANNE_EST, 0);
+    persistParam(filePersistantParam, cPersistantParam);
 #endif 
-          offVanneEst();
-          break;
+    offVanneEst();
+    break;
 
-        case PAC:
+  case PAC:
 #ifdef DEBUG_OUTPUT_SCHEDULE
-          Serial.printf("%02d:%02d PAC ON", h, m);
+    Serial.println("PAC OFF");
 #endif
-          // Envoi de la commande d'aarêt sur l'emetteur IR
-          mqttClient.publish(TOPIC_PAC_IR_OFF, "");
-          // Les commandes IR TOPIC_PAC_IR_OFF sont publiées dans loop
-          // irSendPacOff est mis à false dans monoPacOff
-          irSendPacOff = true; 
-          // Coupure retardée de l'alimentation de la PAC 
-          t_start(tache_t_monoPacOff);
+    // Envoi de la commande d'aarêt sur l'emetteur IR
+    mqttPublish(TOPIC_PAC_IR_OFF, "");
+    // Les commandes IR TOPIC_PAC_IR_OFF sont publiées dans loop
+    // irSendPacOff est mis à false dans monoPacOff
+    irSendPacOff = true; 
+    // Coupure retardée de l'alimentation de la PAC 
+    t_start(tache_t_monoPacOff);
 #ifdef PERSISTANT_PAC            
-          cPersistantParam->set(PAC, 0);
-          filePersistantParam->writeFile(cPersistantParam->getStr(), "w");
+    cPersistantParam->set(PAC, 0);
+    persistParam(filePersistantParam, cPersistantParam);
+#endif
+    break;
+
+  case VMC:
+#ifdef DEBUG_OUTPUT_SCHEDULE
+    Serial.println("off(O_VMC)");
 #endif
-          break;
+    switch (vmcMode) {
+    case VMC_STOP:
+    case VMC_ON:
+    case VMC_ON_FAST: break;
+    default:
+      onVmc = 0;
+      setVmc(CMD_VMC_PROG);
+      break;
+    }
+    break;
+  default: ;
+  }
+}
+
+/**
+ * @brief Publie le prochain événement programmé
+ *        Format hh:mm:deviceId:on|off
+ */
+void publishNextEvent() {
+  char buffer[20];
+  cSchedule->update(cParam);
+  const ScheduleEvent* ev = cSchedule->next();
+  if (ev == NULL) {
+    mqttPublish(TOPIC_NEXT_EVENT, "");
+    return;
+  }
+  sprintf(buffer, "%02d:%02d:%d:%s",
+    ev->minute / 60,
+    ev->minute % 60,
+    ev->deviceId,
+    ev->action == SCHED_ON ? S_ON : S_OFF);
+  mqttPublish(TOPIC_NEXT_EVENT, buffer);
+}
 
-        case VMC:
+/**
+ * @brief Exécute un événement programmé
+ * @param ev événement de la table cSchedule
+ */
+void dispatchEvent(const ScheduleEvent* ev) {
 #ifdef DEBUG_OUTPUT_SCHEDULE
-          Serial.printf("%02d:%02d off(O_VMC)\n", h, m);
+  Serial.printf("%02d:%02d ", ev->minute / 60, ev->minute % 60);
 #endif
-          switch (vmcMode) {
-          case VMC_STOP:
-          case VMC_ON:
-          case VMC_ON_FAST: break;
-          default:
-            onVmc = 0;
-            setVmc(CMD_VMC_PROG);
-            break;
-          }
-          break;
-        default: ;
-        }
+  if (ev->action == SCHED_ON)
+    scheduledOn(ev->deviceId, ev->enable);
+  else
+    scheduledOff(ev->deviceId);
+}
+
+/**
+ * @brief Rattrapage d'un événement manqué
+ *        Amène le dispositif dans l'état prévu par la programmation.
+ *        Le remplissage du réservoir est une impulsion temporisée (monostable) :
+ *        il n'est rejoué que si sa durée n'est pas écoulée.
+ *        Le rattrapage est journalisé par l'appelant, hors CtrlGuard.
+ * @param ev dernier événement manqué du dispositif
+ * @param minute minute courante
+ * @return true si l'événement est rejoué
+ */
+boolean catchUpEvent(const ScheduleEvent* ev, int minute) {
+  int late = (minute - ev->minute + MINUTES_PER_DAY) % MINUTES_PER_DAY;
+  if (ev->deviceId == IRRIGATION && late * 60 >= cDlyParam->get(TIME_TANK_FILLING))
+    return false;
+  dispatchEvent(ev);
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------
+/**
+ * @brief Exécuté toutes les minutes
+ *        Exécute les actions temporelles programmées dans param
+ *        Les plages sont précompilées dans cSchedule (table triée par minute),
+ *        chaque appel avance un curseur jusqu'à la minute courante.
+ * Appelé par loop (on ne peut pas utiliser les timers RTOS (schedule accède aux fichiers))
+ */
+void schedule() {
+  static boolean flagJours = false;
+
+  ItemParam item;
+
+#ifdef DEBUG_HEAP
+  Serial.printf("Free heap %x : min free heap %x\n", ESP.getFreeHeap(), ESP.getMinFreeHeap());
+#endif
+  int h = rtc->getHour(true); // true -> format 24H
+  int m = rtc->getMinute();
+  // Mise à jour du jours courant (persistant) utilisé par circuit secondaire irrigation
+  if (h == 0 && !flagJours) {
+    flagJours = true;
+    if (joursCircuit2 < MAX_DAYS_CIRCUIT2)
+      joursCircuit2++;
+    item = cParam->get(IRRIGATION, 0);
+    item.MMax = joursCircuit2;
+    cParam->set(IRRIGATION, 0, item);
+    saveParam(fileParam, cParam);
+  }
+  if (h == 1 && flagJours) {
+    flagJours = false;
+  }
+  // Reboot automatique à 01:01 pour éviter un bug de l'ESP32 qui bloque le programme
+  if (h == 1 && m == 1) {
+    persistFlush();
+    ESP.restart();
+  }
+
+  // Rattrapages à journaliser (au plus un par dispositif)
+  ScheduleEvent caughtUp[N_DEVICES];
+  int nCaughtUp = 0;
+  {
+    // Actions programmées en exclusion mutuelle avec scanCycle() ; enregistrement
+    // des plages, logs des rattrapages et redémarrage de 01:01 hors verrou
+    CtrlGuard guard;
+    // Recompilation de la table si les paramètres ont été modifiés
+    cSchedule->update(cParam);
+    // Evénements manqués (redémarrage, blocage de loop) en attente de rattrapage
+    const ScheduleEvent* missed[N_DEVICES] = {};
+    const ScheduleEvent* ev;
+    int minute = h * 60 + m;
+    while ((ev = cSchedule->pop(minute)) != NULL) {
+      // Programmation autorisée pour ce device ?
+      if (!cGlobalScheduledParam->get(ev->deviceId))
+        continue;
+      if (ev->minute != minute) {
+        // Seul le dernier événement manqué détermine l'état du dispositif
+        missed[ev->deviceId] = ev;
+        continue;
+      }
+      if (missed[ev->deviceId] != NULL) {
+        if (catchUpEvent(missed[ev->deviceId], minute))
+          caughtUp[nCaughtUp++] = *missed[ev->deviceId];
+        missed[ev->deviceId] = NULL;
       }
+      dispatchEvent(ev);
     }
+    for (int deviceId = 0; deviceId < N_DEVICES; deviceId++) {
+      if (missed[deviceId] != NULL && catchUpEvent(missed[deviceId], minute))
+        caughtUp[nCaughtUp++] = *missed[deviceId];
+    }
+    // Conservé en mémoire RTC pour le rattrapage après redémarrage
+    cSchedule->save(rtc->getEpoch());
+  }
+  for (int i = 0; i < nCaughtUp; i++)
+    writeEvent(caughtUp[i].action == SCHED_ON ? EV_CATCH_UP_ON : EV_CATCH_UP_OFF,
+               caughtUp[i].deviceId, caughtUp[i].minute);
+  // Compte de jours du circuit 2 remis à zéro par scheduledOn()
+  if (paramSavePending) {
+    paramSavePending = false;
+    saveParam(fileParam, cParam);
   }
 }
 
@@ -1332,6 +1543,7 @@ void schedule() {
  */
 void startWatering(int timeout) {
   // Serial.println("Start waterring");
+  CtrlGuard guard;
   if (timeout) {
     setDelay(tache_t_watering, cvrtic(cDlyParam->get(TIME_WATERING) * 1000));
     t_start(tache_t_watering);
@@ -1340,9 +1552,11 @@ void startWatering(int timeout) {
   else
     wateringNoTimeOut = 2;
   isWatering = true;
+  ioBegin();
   on(O_TRANSFO);
   on(O_EV_ARROSAGE);
   on(O_POMPE);
+  ioCommit();
 }
 /**
  * @brief  Arrêt lance arrosage
@@ -1350,10 +1564,13 @@ void startWatering(int timeout) {
  * @retval None
  */
 void stopWatering() {
+  CtrlGuard guard;
   t_stop(tache_t_watering);
+  ioBegin();
   off(O_POMPE);
   off(O_TRANSFO);
   off(O_EV_ARROSAGE);
+  ioCommit();
   isWatering = false;
   wateringNoTimeOut = 0;
 }
@@ -1367,10 +1584,13 @@ void stopWatering() {
  * @retval None
  */
 void startTankFilling() {
+  CtrlGuard guard;
   setDelay(tache_t_tankFilling, cvrtic(cDlyParam->get(TIME_TANK_FILLING) * 1000));
   t_start(tache_t_tankFilling);
   isTankFilling = true;
   // Priorité au remplissage si utilisation de la pompe en cours
+  // Commutation simultanée des relais (une seule écriture des registres)
+  ioBegin();
   if (isWatering) {
     on(O_EV_IRRIGATION);
     off(O_EV_ARROSAGE);
@@ -1380,7 +1600,9 @@ void startTankFilling() {
   else {
     on(O_TRANSFO);
     on(O_EV_IRRIGATION);
-    on(O_POMPE);  }
+    on(O_POMPE);
+  }
+  ioCommit();
 }
 /**
  *@brief Arrêt remplissage réservoir
@@ -1388,10 +1610,13 @@ void startTankFilling() {
  */
 void stopTankFilling() {
   // Serial.println("stopTankFilling");
+  CtrlGuard guard;
   t_stop(tache_t_tankFilling);
+  ioBegin();
   off(O_POMPE);
   off(O_TRANSFO);
   off(O_EV_IRRIGATION);
+  ioCommit();
   isTankFilling = false;
 }
 
@@ -1419,9 +1644,10 @@ boolean isEdge(int nInput) {
  */
 void setVmc(int cmd) {
   static boolean co2LastFastMode=false;
+  CtrlGuard guard;
 #ifdef PERSISTANT_VMC
   cPersistantParam->set(VMC, cmd);
-  filePersistantParam->writeFile(cPersistantParam->getStr(), "w");
+  persistParam(filePersistantParam, cPersistantParam);
 #endif
   // Serial.printf("SetVmc : %d\n", cmd);
   switch (cmd) {
@@ -1571,7 +1797,7 @@ void setVmc(int cmd) {
   }
   char buffer[4];
   itoa(vmcMode, buffer, 10);
-  mqttClient.publish(TOPIC_STATUS_VMC, buffer); 
+  mqttPublish(TOPIC_STATUS_VMC, buffer); 
 }
 
 
@@ -1586,25 +1812,42 @@ void loop() {
   static ulong tpsProg = 0;
   static ulong tpsRotaryUpdt = 0;
   static ulong tpsSchedule = 0;
+  static ulong tpsPersist = 0;
+  static ulong tpsFlashStats = 0;
+  static ulong tpsFileSync = 0;
   static ulong tpsWifiTest = 0;
   static ulong tpsWDTReset = 0;
   static ulong tpsWifiSignalStreng = INTERVAL_WIFI_STRENG_SEND;
-  static unsigned mqttConnectTest=0;
   static boolean esp_task_wdt = true;
   static unsigned rotate;
 
-#ifdef EXEC_TIME_MEASURE
-  time_exec_start();
-#endif
+  // Durée de l'itération (histogramme PROF_LOOP)
+  ProfTimer loopTimer(PROF_LOOP);
  
+#ifndef SCAN_TASK
+  // Ecriture unique des relais modifiés depuis le cycle précédent
+  // (loop et callbacks des temporisateurs)
+  ioFlush();
+#endif
   ArduinoOTA.handle();
 #ifdef IO_TEST
   return;
 #endif    
-  mqttClient.loop();
+  {
+    // Les callbacks MQTT et Alexa modifient l'état partagé avec scanCycle()
+    CtrlGuard guard;
+    {
+      ProfTimer timer(PROF_MQTT_LOOP);
+      mqttClient.loop();
+    }
 #ifdef ALEXA  
-  fauxmo.handle();
+    ProfTimer timer(PROF_FAUXMO);
+    fauxmo.handle();
 #endif  
+  }
+  // Publications en attente (callbacks, temporisateurs, tâche de scrutation),
+  // hors exclusion mutuelle : une écriture lente sur le réseau ne retarde pas scanCycle()
+  mqttQueueDrain(mqttClient);
 #ifdef ENABLE_WATCHDOG
   // Reset du chien de garde
   if (millis() - tpsWDTReset > INTERVAL_RESET_WDT) {
@@ -1635,19 +1878,18 @@ void loop() {
   //   }
   // }
 
-  // Vérification cnx broker MQTT
-  if (!mqttClient.connected() && 
-      millis() - mqttConnectTest > INTERVAL_MQTT_CONNECT_TEST) {
-    mqttConnectTest = millis();
-    if (initWifiStation(false)) 
-      if (mqttConnect = initMQTTClient(false))
-        lcdPrintChar('c', 2, 0);
-      else
-        lcdPrintChar('n', 2, 0);
-    else
-        lcdPrintChar('n', 2, 0);
+  // Connexion WiFi / courtier MQTT : une étape de l'automate par passage,
+  // hors exclusion mutuelle (la scrutation se poursuit pendant une coupure)
+  boolean netUp = netLinkLoop() == NET_UP;
+  if (netUp != mqttConnect) {
+    mqttConnect = netUp;
+    lcdPrintChar(netUp ? 'c' : 'n', 2, 0);
   }
 
+  // Reste de la boucle hors exclusion mutuelle avec scanCycle() : l'afficheur
+  // (LcdGuard), la mémoire flash et les compteurs ont leurs propres verrous.
+  // Les commandes des dispositifs (menus rotary, schedule) prennent CtrlGuard.
+
   // Scruter les ports E/S toutes les s pour les afficher sur LCD
   // static unsigned uPortIn_1  = 0xFFFFFFFF;
   // static unsigned uPortOut_1 = 0xFFFFFFFF;
@@ -1665,13 +1907,17 @@ void loop() {
 
     // Ne mettre à jour l'affichage que si changement
     // ioChange est mis à true dans les fonctions off(port) et on(port)
-    if (ioChange) { 
-      display();
+    // Remise à false avant l'affichage : un changement posté par un
+    // temporisateur pendant display() sera traité au cycle suivant
+    if (ioChange.exchange(false)) { 
+      {
+        ProfTimer timer(PROF_DISPLAY);
+        display();
+      }
       // Publication de l'état des ports GPIO sur MQTT si client connecté
       if (appConnected==1) {
         publishGpio();
       }
-      ioChange = false;
     }  
     
     // Ancienne méthode de scrutation des ports E/S,
@@ -1699,13 +1945,32 @@ void loop() {
     // if (setDisplay) display();
   }
 
+#ifndef SCAN_TASK
   // Scrutation évenements E/S toutes les 100 ms
   if (millis() - tps > INTERVAL_IO_SCRUT) {
     // static int i = 0;
     tps = millis();
     // Serial.printf("Loop %d\n", xPortGetCoreID());
-    localLoop();
+    scanCycle();
+  }
+#endif
+  // Logs en cache écrits en mémoire flash
+  if (millis() - tpsFileSync > INTERVAL_FILE_SYNC) {
+    tpsFileSync = millis();
+    FileLittleFS::syncAll();
   }
+  // Compteurs d'écritures flash (mise hors tension)
+  if (millis() - tpsFlashStats > INTERVAL_FLASH_STATS_SAVE) {
+    tpsFlashStats = millis();
+    flashStatsSave();
+  }
+#ifndef PERSIST_TASK
+  // Enregistrement différé des paramètres
+  if (millis() - tpsPersist > INTERVAL_PERSIST_POLL) {
+    tpsPersist = millis();
+    persistPoll();
+  }
+#endif
 
   // Mise à jour de l'indicateur tournant sur l'écran lcd toute les 500 ms
   // isLcdDisplayOn = true;
@@ -1727,14 +1992,22 @@ void loop() {
   // Envoi toutes les 15s d'une commande IR off sur la PAC si cycle d'arrèt
   if (irSendPacOff && millis() - tpsIr > INTERVAL_IR_SEND) {
     tpsIr = millis();
-    mqttClient.publish(TOPIC_PAC_IR_OFF, "");  
+    mqttPublish(TOPIC_PAC_IR_OFF, "");  
   }
 
-  // Appel de schedule toutes les minutes
-  // pour les actions programmées
+  // Appel de schedule à chaque changement de minute de l'horloge
+  // pour les actions programmées. Un intervalle fixe de 60s dérive par
+  // rapport à l'horloge et finit par sauter une minute.
+  // Premier appel à la minute suivant le démarrage.
   if (millis() - tpsSchedule > INTERVAL_SCHEDULE) {
+    static int lastMinute = -1;
     tpsSchedule = millis();
-    schedule();
+    int minute = rtc->getMinute();
+    if (lastMinute != -1 && minute != lastMinute) {
+      ProfTimer timer(PROF_SCHEDULE);
+      schedule();
+    }
+    lastMinute = minute;
   }
   
   // Envoi du niveau en db WiFi RSSI
@@ -1743,7 +2016,7 @@ void loop() {
     if (!isLcdDisplayOn || !wifiConnected) {
       return;
     //long rssi = WiFi.RSSI();
-      sprintf(rssi_buffer, "RSSI:%ld", WiFi.RSSI());
+      snprintf(rssi_buffer, sizeof(rssi_buffer), "RSSI:%d", (int)WiFi.RSSI());
     // Test niveau RSSI
     // mqttClient.publish(TOPIC_WIFI_STRENG, rssi_buffer);
       lcdPrintRssi(rssi_buffer);
@@ -1753,321 +2026,506 @@ void loop() {
   // Suspend pour 5s, ne pas utiliser ici
   // esp_sleep_enable_timer_wakeup(5000000); // 5 seconds
   // esp_light_sleep_start();
-#ifdef EXEC_TIME_MEASURE
-  time_exec_stop();
-#endif
 }
 
-/**
- *@brief  Réception des messages MQTT
- *        Attention si le buffer MQTT est trop petit le message correspondant est
- *        supprimé. Voir commentaires en-tête de ce fichier
- * 
- * @param topic 
- * @param payload 
- * @param length 
- */
-void PubSubCallback(char* topic, byte* payload, unsigned int length) {
-  String strPayload = "";
-  // Préserver le payload dans un buffer, utile que si on se réutilise payload
-  // dans une commande MQTT
-  // char buffer[80];
-  // static char bufferPayload[512];
-  // memcpy(bufferPayload, payload, length + 4);
-
-  for (unsigned int i = 0; i < length; i++) {
-    strPayload += static_cast<char>(payload[i]);
-  }
-
-#ifdef DEBUG_TOPIC
-  Serial.print(topic);
-  Serial.print(" : ");
-  Serial.println(strPayload.c_str());
-#endif
-
-  //------------------  TOPIC_GET_PARAM ----------------------
-  if (cmp(topic, TOPIC_GET_PARAM)) {
+//------------------  TOPIC_GET_PARAM ----------------------
+static void onGetParam(const TopicPayload&) {
 #ifdef DEBUG_OUTPUT
-    print(cParam->getStr(), OUTPUT_PRINT);
+  print(cParam->getStr(), OUTPUT_PRINT);
 #endif
-    // Modifier la chaine param pour refléter la valeur de jours courant
-    ItemParam item = cParam->get(IRRIGATION, 0);
-    item.MMax = joursCircuit2;
-    cParam->set(IRRIGATION, 0, item);
-    cParam->updateStringParam(cParam->getStr());
-    // cParam->print();
-    mqttClient.publish(TOPIC_PARAM, cParam->getStr());
-    if (erreurSupresseurEvent) {
-      erreurSupresseurEvent = false;
-      mqttClient.publish(TOPIC_DEFAUT_SUPRESSOR, "on");
-    }
-    if (erreurPompEvent) {
-      erreurPompEvent = false;
-      mqttClient.publish(TOPIC_DEFAUT_SUPRESSOR, "on2");
-    }
-    // if (supressorFillingSecurity){
-    //   mqttClient.publish(TOPIC_SUPRESSOR_SECURITY, "on");
-    // }
-    // else {
-    //   mqttClient.publish(TOPIC_SUPRESSOR_SECURITY, "off");
-    // }
-    return;
+  // Modifier la chaine param pour refléter la valeur de jours courant
+  ItemParam item = cParam->get(IRRIGATION, 0);
+  item.MMax = joursCircuit2;
+  cParam->set(IRRIGATION, 0, item);
+  // cParam->print();
+  mqttClient.publish(TOPIC_PARAM, cParam->getStr());
+  if (erreurSupresseurEvent) {
+    erreurSupresseurEvent = false;
+    mqttPublish(TOPIC_DEFAUT_SUPRESSOR, "on");
   }
-  //------------------  TOPIC_WRITE_PARAM ----------------------
-  // Attention taille du message importante 
-  if (cmp(topic, TOPIC_WRITE_PARAM)) {
-    cParam->setStr(strPayload.c_str());
-#ifdef DEBUG_OUTPUT
-    print(cParam->getStr(), OUTPUT_PRINT);
-#endif
-    fileParam->writeFile(strPayload.c_str(), "w");
-    return;
+  if (erreurPompEvent) {
+    erreurPompEvent = false;
+    mqttPublish(TOPIC_DEFAUT_SUPRESSOR, "on2");
   }
-  //------------------  TOPIC_GET_DLY_PARAM ----------------------
-  if (cmp(topic, TOPIC_GET_DLY_PARAM)) {
-    // cDlyParam->print();
-    mqttClient.publish(TOPIC_DLY_PARAM, cDlyParam->getStr());
+  // if (supressorFillingSecurity){
+  //   mqttClient.publish(TOPIC_SUPRESSOR_SECURITY, "on");
+  // }
+  // else {
+  //   mqttClient.publish(TOPIC_SUPRESSOR_SECURITY, "off");
+  // }
+}
+
+//------------------  TOPIC_WRITE_PARAM ----------------------
+// Attention taille du message importante 
+static void onWriteParam(const TopicPayload& payload) {
+  if (!cParam->setStr(payload.text())) {
+    // Paramètres rejetés : les plages courantes sont conservées
+    logsWrite(cParam->error());
     return;
   }
-  //------------------  TOPIC_WRITE_DLY_PARAM ----------------------
-  if (cmp(topic, TOPIC_WRITE_DLY_PARAM)) {
-    cDlyParam->setStr(strPayload.c_str());
 #ifdef DEBUG_OUTPUT
-    print(cDlyParam->getStr(), OUTPUT_PRINT);
+  print(cParam->getStr(), OUTPUT_PRINT);
 #endif
-    fileDlyParam->writeFile(strPayload.c_str(), "w");
-    if (cDlyParam->get(SUPRESSOR_EN)) {
-       mqttClient.publish(TOPIC_SUPRESSOR_SECURITY, "off");
-       supressorFillingSecurity = false;
-    }
-    // Mis à jour si modification de auto surpresseur
-    // cDlyParam->print();
-    ioDisplay();
-		display = ioDisplay;
-    return;
-  }
-  //------------------  TOPIC_GET_GPIO ----------------------
-  if (cmp(topic, TOPIC_GET_GPIO)) {
-    publishGpio();
+  saveParam(fileParam, cParam);
+}
+
+//------------------  TOPIC_GET_DLY_PARAM ----------------------
+static void onGetDlyParam(const TopicPayload&) {
+  // cDlyParam->print();
+  mqttClient.publish(TOPIC_DLY_PARAM, cDlyParam->getStr());
+}
+
+//------------------  TOPIC_WRITE_DLY_PARAM ----------------------
+static void onWriteDlyParam(const TopicPayload& payload) {
+  if (!cDlyParam->setStr(payload.text())) {
+    // Paramètres rejetés : valeurs courantes conservées
+    logsWrite(cDlyParam->error());
     return;
   }
-  //------------------  TOPIC_CMD_ARROSAGE ----------------------
-  if (cmp(topic, TOPIC_CMD_ARROSAGE)) {
-    unsigned cmd = atoi(strPayload.c_str());
-    switch (cmd) {
-    case 0:
-      // Serial.println("TOPIC_CMD_ARROSAGE Stop watering");
-      stopWatering();
-      wateringNoTimeOut = 0;
-      mqttClient.publish(TOPIC_STATUS_WATERING, "off");    
-      break;
-    case 1:
-      // Serial.println("Watering timeout");
-      startWatering(TIMEOUT);
-      wateringNoTimeOut = 0;
-      mqttClient.publish(TOPIC_STATUS_WATERING, "on");  
-      break;
-    case 2:
-      // Serial.println("Watering no timeout");
-      startWatering(NO_TIMEOUT);
-      wateringNoTimeOut = 2;   
-      mqttClient.publish(TOPIC_STATUS_WATERING, "on");
-      break;
-    }
-    return;
+#ifdef DEBUG_OUTPUT
+  print(cDlyParam->getStr(), OUTPUT_PRINT);
+#endif
+  persistParam(fileDlyParam, cDlyParam);
+  if (cDlyParam->get(SUPRESSOR_EN)) {
+     mqttPublish(TOPIC_SUPRESSOR_SECURITY, "off");
+     supressorFillingSecurity = false;
   }
-  //------------------  TOPIC_CMD_IRRIGATION ----------------------
-  if (cmp(topic, TOPIC_CMD_IRRIGATION)) {
-    unsigned cmd = atoi(strPayload.c_str());
-    if (cmd)
-      startTankFilling();
-    else
-      stopTankFilling();
-    return;
+  // Mis à jour si modification de auto surpresseur
+  // cDlyParam->print();
+  ioDisplay();
+		display = ioDisplay;
+}
+
+//------------------  TOPIC_GET_GPIO ----------------------
+static void onGetGpio(const TopicPayload&) {
+  publishGpio();
+}
+
+//------------------  TOPIC_CMD_ARROSAGE ----------------------
+static void onCmdArrosage(const TopicPayload& payload) {
+  unsigned cmd = payload.toInt();
+  switch (cmd) {
+  case 0:
+    // Serial.println("TOPIC_CMD_ARROSAGE Stop watering");
+    stopWatering();
+    wateringNoTimeOut = 0;
+    mqttPublish(TOPIC_STATUS_WATERING, "off");    
+    break;
+  case 1:
+    // Serial.println("Watering timeout");
+    startWatering(TIMEOUT);
+    wateringNoTimeOut = 0;
+    mqttPublish(TOPIC_STATUS_WATERING, "on");  
+    break;
+  case 2:
+    // Serial.println("Watering no timeout");
+    startWatering(NO_TIMEOUT);
+    wateringNoTimeOut = 2;   
+    mqttPublish(TOPIC_STATUS_WATERING, "on");
+    break;
   }
-  //------------------  TOPIC_CMD_CUISINE ----------------------
-  if (cmp(topic, TOPIC_CMD_CUISINE)) {
-    unsigned cmd = atoi(strPayload.c_str());
+}
+
+//------------------  TOPIC_CMD_IRRIGATION ----------------------
+static void onCmdIrrigation(const TopicPayload& payload) {
+  unsigned cmd = payload.toInt();
+  if (cmd)
+    startTankFilling();
+  else
+    stopTankFilling();
+}
+
+//------------------  TOPIC_CMD_CUISINE ----------------------
+static void onCmdCuisine(const TopicPayload& payload) {
+  unsigned cmd = payload.toInt();
 #ifdef PERSISTANT_POWER_COOK   
-    cPersistantParam->set(POWER_COOK, cmd);
-    filePersistantParam->writeFile(cPersistantParam->getStr(), "w");
+  cPersistantParam->set(POWER_COOK, cmd);
+  persistParam(filePersistantParam, cPersistantParam);
 #endif  
-    if (cmd==1) {
-      on(O_FOUR);
-      mqttClient.publish(TOPIC_STATUS_CUISINE, "on");      
-    }
-    else  if (cmd==0){
-      off(O_FOUR);
-      mqttClient.publish(TOPIC_STATUS_CUISINE, "off");   
-    }
-    return;
+  if (cmd==1) {
+    on(O_FOUR);
+    mqttPublish(TOPIC_STATUS_CUISINE, "on");      
   }
-  //------------------  TOPIC_CMD_VMC ----------------------
-  if (cmp(topic, TOPIC_CMD_VMC)) {
-    unsigned cmd = atoi(strPayload.c_str());
-    setVmc(cmd);
-    return;
+  else  if (cmd==0){
+    off(O_FOUR);
+    mqttPublish(TOPIC_STATUS_CUISINE, "off");   
   }
-  //------------------  TOPIC_CMD_VANNE_EST ----------------------
-  if (cmp(topic, TOPIC_CMD_VANNE_EST)) {
-    unsigned cmd = atoi(strPayload.c_str());
-    if (cmd) {
-      on(O_TRANSFO);
-      on(O_EV_EST);
-      setDelay(tache_t_cmdEvEst, cvrtic(cDlyParam->get(EAST_VALVE_ON_TIME) * 1000));
-      t_start(tache_t_cmdEvEst);
-      onVanneEst();
-    }
-    else {
-      // off(O_TRANSFO);
-      // off(O_EV_EST);
-      t_stop(tache_t_cmdEvEst);
-      offVanneEst();
-    }
-    return;
+}
 
-    // sprintf(buffer, "topic : %s, port %s\n", topic, bufferPayload.c_str());
-    // print(buffer, OUTPUT_PRINT);
+//------------------  TOPIC_CMD_VMC ----------------------
+static void onCmdVmc(const TopicPayload& payload) {
+  unsigned cmd = payload.toInt();
+  setVmc(cmd);
+}
 
-    // cmdVanneEst = cmp(strPayload.c_str(), "1");
-    return;
+//------------------  TOPIC_CMD_VANNE_EST ----------------------
+static void onCmdVanneEst(const TopicPayload& payload) {
+  unsigned cmd = payload.toInt();
+  if (cmd) {
+    ioBegin();
+    on(O_TRANSFO);
+    on(O_EV_EST);
+    ioCommit();
+    setDelay(tache_t_cmdEvEst, cvrtic(cDlyParam->get(EAST_VALVE_ON_TIME) * 1000));
+    t_start(tache_t_cmdEvEst);
+    onVanneEst();
+  }
+  else {
+    // off(O_TRANSFO);
+    // off(O_EV_EST);
+    t_stop(tache_t_cmdEvEst);
+    offVanneEst();
   }
-  //------------------  TOPIC_CMD_PAC ----------------------
-  if (cmp(topic, TOPIC_CMD_PAC)) {
-    unsigned cmd = atoi(strPayload.c_str());
-    // Logique inversée pour relai PAC
-    // 1 = arret
-    if (cmd) {
-      // Arrèter la PAC via IR
-      // Serial.println("Arreter la PAC via IR");
-      mqttClient.publish(TOPIC_PAC_IR_OFF, "");
-      mqttClient.publish(TOPIC_STATUS_PAC, S_OFF_SHUTDOWN);           
-      // Couper alim PAC après DLY_OFF secondes
-      t_start(tache_t_monoPacOff); // Logique inversée pour relai PAC
-      t_stop(tache_t_monoPacOn);
-      irSendPacOff = true;
-      // Mettre à jour l'affichage sur l'appli
-      ioChange = true;
+  return;
+
+  // sprintf(buffer, "topic : %s, port %s\n", topic, bufferPayload.c_str());
+  // print(buffer, OUTPUT_PRINT);
+
+  // cmdVanneEst = cmp(strPayload.c_str(), "1");
+}
+
+//------------------  TOPIC_CMD_PAC ----------------------
+static void onCmdPac(const TopicPayload& payload) {
+  unsigned cmd = payload.toInt();
+  // Logique inversée pour relai PAC
+  // 1 = arret
+  if (cmd) {
+    // Arrèter la PAC via IR
+    // Serial.println("Arreter la PAC via IR");
+    mqttPublish(TOPIC_PAC_IR_OFF, "");
+    mqttPublish(TOPIC_STATUS_PAC, S_OFF_SHUTDOWN);           
+    // Couper alim PAC après DLY_OFF secondes
+    t_start(tache_t_monoPacOff); // Logique inversée pour relai PAC
+    t_stop(tache_t_monoPacOn);
+    irSendPacOff = true;
+    // Mettre à jour l'affichage sur l'appli
+    ioChange = true;
 #ifdef PERSISTANT_PAC
-      cPersistantParam->set(PAC, 0);
+    cPersistantParam->set(PAC, 0);
 #endif
-    }
-    else {
-      // mettre la PAC sous tension
-      irSendPacOff = false;
-      on(O_PAC);  
-      mqttClient.publish(TOPIC_STATUS_PAC, S_OFF);     
-      mqttClient.publish(TOPIC_STATUS_PAC, S_ON);       
+  }
+  else {
+    // mettre la PAC sous tension
+    irSendPacOff = false;
+    on(O_PAC);  
+    mqttPublish(TOPIC_STATUS_PAC, S_OFF);     
+    mqttPublish(TOPIC_STATUS_PAC, S_ON);       
 #ifdef PERSISTANT_PAC
-      cPersistantParam->set(PAC, 1);
+    cPersistantParam->set(PAC, 1);
 #endif
-      t_start(tache_t_monoPacOn);
-      t_stop(tache_t_monoPacOff);
-    }
+    t_start(tache_t_monoPacOn);
+    t_stop(tache_t_monoPacOff);
+  }
 #ifdef PERSISTANT_PAC
-    filePersistantParam->writeFile(cPersistantParam->getStr(), "w");
+  persistParam(filePersistantParam, cPersistantParam);
 #endif
+}
+
+//---------------  TOPIC_CMD_REAMORCER  -------------------
+static void onCmdReamorcer(const TopicPayload&) {
+  #ifdef DEBUG_OUTPUT
+  Serial.println(TOPIC_CMD_REAMORCER);
+  #endif
+  msgRearm = true;
+}
+
+//------------------  TOPIC_LOGS_GET ----------------------
+static void onLogsGet(const TopicPayload& payload) {
+  // Payload : premier numéro souhaité (numéro reçu sur TOPIC_LOGS_SEQ), sinon tout le journal
+  uint32_t from = payload.toInt();
+  // La taille du message est limitée par l'implémentation de MQTT
+  // pour les ESP, il faut fractionner le message lignes/lignes
+  uint32_t next = logStore->read(from, publishLog, NULL);
+  char buffer[12];
+  snprintf(buffer, sizeof(buffer), "%lu", (unsigned long)next);
+  mqttClient.publish(TOPIC_LOGS_SEQ, buffer);
+  // Message de fin
+  mqttClient.publish(TOPIC_READ_LOGS, "#####");
+}
+
+//------------------  TOPIC_CLEAR_LOGS ----------------------
+static void onClearLogs(const TopicPayload&) {
+  logStore->clear();
+  logsWrite("Log cleared");
+}
+
+//------------------  TOPIC_REBOOT ----------------------
+static void onReboot(const TopicPayload&) {
+  persistFlush();
+  ESP.restart();
+}
+
+//------------------  TOPIC_GET_VERSION ----------------------
+static void onGetVersion(const TopicPayload&) {
+  // long rssi = WiFi.RSSI();
+  // sprintf(rssi_buffer, "RSSI:%ld", WiFi.RSSI());
+  static char info[128];
+  sprintf(info, "%s\n%s, RSSI:%ddb\n%s", 
+                 version, WiFi.localIP().toString().c_str(), (int)WiFi.RSSI(), getDate());
+  // String info = String(version) + "\n" + WiFi.localIP().toString() + ", " + rssi_buffer + "db\n" + String(getDate());
+  // Serial.println(info);
+  mqttClient.publish(TOPIC_READ_VERSION, info);
+}
+
+//------------------  TOPIC_WATCH_DOG_OFF ----------------------
+static void onWatchDogOff(const TopicPayload&) {
+  esp_task_wdt_delete(NULL);
+  delay(1);
+  //Serial.println("WD disabled"); 
+}
+
+//------------------  TOPIC_GLOBAL_SCHED_GET ----------------------
+static void onGetGlobalSched(const TopicPayload&) {
+  mqttClient.publish(TOPIC_GLOBAL_SCHED, cGlobalScheduledParam->getStr());
+}
+
+//------------------  TOPIC_GLOBAL_SCHED_WRITE ----------------------
+static void onWriteGlobalSched(const TopicPayload& payload) {
+  // Mettre à jour l'objet
+  if (!cGlobalScheduledParam->setStr(payload.text())) {
+    logsWrite(cGlobalScheduledParam->error());
     return;
   }
-  //---------------  TOPIC_CMD_REAMORCER  -------------------
-  if (cmp(topic, TOPIC_CMD_REAMORCER)) {
-    #ifdef DEBUG_OUTPUT
-    Serial.println(TOPIC_CMD_REAMORCER);
-    #endif
-    msgRearm = true;
-    return;
-  }
-  //------------------  TOPIC_LOGS_GET ----------------------
-  if (cmp(topic, TOPIC_LOGS_GET)) {
-    if (!fileLogs->exist())
-      return;
-    String logs = fileLogs->readFile();
-    // Serial.println(logs);
-    unsigned i = 0;
-    // La taille du message est limitée par l'implémentation de MQTT
-    // pour les ESP, il faut fractionner le message lignes/lignes
-    while (i < logs.length()) {
-      String partial = logs.substring(i, logs.indexOf("\n", i) + 1);
-      mqttClient.publish(TOPIC_READ_LOGS, partial.c_str());
-      // Serial.print(partial);
-      i = logs.indexOf("\n", i) + 1;
-    }
-    // Message de fin
-    mqttClient.publish(TOPIC_READ_LOGS, "#####");
-    return;
-  }
-  //------------------  TOPIC_CLEAR_LOGS ----------------------
-  if (cmp(topic, TOPIC_CLEAR_LOGS)) {
-    fileLogs->writeFile("Log cleared\n", "w");
-    return;
-  }
-  //------------------  TOPIC_REBOOT ----------------------
-  if (cmp(topic, TOPIC_REBOOT)) {
-    ESP.restart();
-    return;
-  }
-  //------------------  TOPIC_GET_VERSION ----------------------
-  if (cmp(topic, TOPIC_GET_VERSION)) {
-    // long rssi = WiFi.RSSI();
-    // sprintf(rssi_buffer, "RSSI:%ld", WiFi.RSSI());
-    static char info[128];
-    sprintf(info, "%s\n%s, RSSI:%lddb\n%s", 
-                   version, WiFi.localIP().toString().c_str(), WiFi.RSSI(), getDate());
-    // String info = String(version) + "\n" + WiFi.localIP().toString() + ", " + rssi_buffer + "db\n" + String(getDate());
-    // Serial.println(info);
-    mqttClient.publish(TOPIC_READ_VERSION, info);
-    return;
-  }
-  //------------------  TOPIC_WATCH_DOG_OFF ----------------------
-  if (cmp(topic, TOPIC_WATCH_DOG_OFF)) {
-    esp_task_wdt_delete(NULL);
-    delay(1);
-    //Serial.println("WD disabled"); 
-    return;
-  }
-  //------------------  TOPIC_GLOBAL_SCHED_GET ----------------------
-  if (cmp(topic, TOPIC_GET_GLOBAL_SCHED)) {
-    mqttClient.publish(TOPIC_GLOBAL_SCHED, cGlobalScheduledParam->getStr());
-    return;
-  }
-  //------------------  TOPIC_GLOBAL_SCHED_WRITE ----------------------
-  if (cmp(topic, TOPIC_WRITE_GLOBAL_SCHED)) {
-    // Mettre à jour l'objet
-    cGlobalScheduledParam->setStr(strPayload.c_str());
 #ifdef DEBUG_OUTPUT
-    print(cGlobalScheduledParam->getStr(), OUTPUT_PRINT);
+  print(cGlobalScheduledParam->getStr(), OUTPUT_PRINT);
 #endif
-    fileGlobalScheduledParam->writeFile(strPayload.c_str(), "w");
-    return;
+  persistParam(fileGlobalScheduledParam, cGlobalScheduledParam);
+}
+
+//------------------  TOPIC_APP_CONNECT ----------------------
+static void onAppConnect(const TopicPayload& payload) {
+  appConnected = payload.toInt();
+}
+
+/**
+ * @brief Publication de l'état des appareils
+ *        (demande de l'application, reconnexion au courtier)
+ */
+void publishStatus() {
+  char buffer[4];
+  itoa(vmcMode, buffer, 10);
+  mqttPublish(TOPIC_STATUS_VMC, buffer); 
+  mqttPublish(TOPIC_STATUS_CUISINE, gpioState(O_FOUR) ? "on" : "off"); 
+  switch (pacStatus) {
+    case PAC_STATUS_OFF  : mqttPublish(TOPIC_STATUS_PAC, S_OFF); break; 
+    case PAC_STATUS_OFFS : mqttPublish(TOPIC_STATUS_PAC, S_OFF_SHUTDOWN); break;
+    case PAC_STATUS_ON   : mqttPublish(TOPIC_STATUS_PAC, S_ON); break;
   }
-  //------------------  TOPIC_APP_CONNECT ----------------------
-  if (cmp(topic, TOPIC_APP_CONNECT)) {
-    appConnected = atoi(strPayload.c_str());
-    return;
+  if (!erreurSupresseur && !erreurPompe)
+    mqttPublish(TOPIC_DEFAUT_SUPRESSOR, "off");
+  else if (erreurSupresseur)
+    mqttPublish(TOPIC_DEFAUT_SUPRESSOR, "on");
+  else
+    mqttPublish(TOPIC_DEFAUT_SUPRESSOR, "on2");             
+}
+
+//------------------  TOPIC_MQTT_GET_STATUS ----------------------
+static void onMqttGetStatus(const TopicPayload&) {
+  publishStatus();
+}
+
+//------------------  TOPIC_GET_NEXT_EVENT ----------------------
+static void onGetNextEvent(const TopicPayload&) {
+  publishNextEvent();
+}
+
+//------------------  TOPIC_GET_IO_STATS ----------------------
+static void onGetIoStats(const TopicPayload&) {
+  char buffer[48];
+  const IoStats* stats = ioStats();
+  // scans;commutations GPIO dernier cycle;max commutations;âge instantané (ms)
+  sprintf(buffer, "%lu;%u;%u;%lu",
+    stats->scans,
+    stats->lastScanToggles,
+    stats->maxScanToggles,
+    millis() - stats->inputTimestamp);
+  mqttClient.publish(TOPIC_IO_STATS, buffer);
+}
+
+//------------------  TOPIC_GET_SCAN_STATS ----------------------
+static void onGetScanStats(const TopicPayload&) {
+  char buffer[80];
+  ScanStats stats;
+  scanStatsTake(&stats);
+  // cycles;min;moy;max (us);gigue max (us);dépassements de période
+  sprintf(buffer, "%lu;%lu;%lu;%lu;%lu;%lu",
+    stats.scans,
+    stats.minUs,
+    stats.scans ? stats.sumUs / stats.scans : 0,
+    stats.maxUs,
+    stats.maxJitterUs,
+    stats.overruns);
+  mqttClient.publish(TOPIC_SCAN_STATS, buffer);
+}
+
+//------------------  TOPIC_GET_PROFILE ----------------------
+// Un message par section :
+// nom;mesures;max (us);<100us;<500us;<1ms;<5ms;<10ms;<50ms;<100ms;>=100ms
+static void onGetProfile(const TopicPayload&) {
+  static ProfHistogram histograms[PROF_N_SECTIONS];
+  char buffer[128];
+  profTake(histograms);
+  for (int i = 0; i < PROF_N_SECTIONS; i++) {
+    ProfHistogram* h = &histograms[i];
+    int n = sprintf(buffer, "%s;%lu;%lu", profName(i), h->count, h->maxUs);
+    for (int b = 0; b < PROF_N_BUCKETS; b++)
+      n += sprintf(buffer + n, ";%lu", h->buckets[b]);
+    mqttClient.publish(TOPIC_PROFILE, buffer);
+  }
+}
+
+//------------------  TOPIC_GET_FLASH_STATS ----------------------
+// Un message par fichier : fichier;écritures;octets;suppressions
+// puis le total : *;écritures;octets;écritures dernière heure;budget (tous fichiers);logs supprimés
+static void onGetFlashStats(const TopicPayload&) {
+  char buffer[80];
+  static FlashStats stats;
+  flashStatsTake(&stats);
+  unsigned long writes = 0, bytes = 0;
+  for (unsigned i = 0; i < stats.nFiles; i++) {
+    const FlashFileStats& file = stats.files[i];
+    writes += file.writes;
+    bytes += file.bytes;
+    sprintf(buffer, "%s;%lu;%lu;%lu", file.path,
+            (unsigned long)file.writes, (unsigned long)file.bytes, (unsigned long)file.removes);
+    mqttClient.publish(TOPIC_FLASH_STATS, buffer);
   }
-  //------------------  TOPIC_MQTT_GET_STATUS ----------------------
-  if (cmp(topic, TOPIC_MQTT_GET_STATUS)) { 
-    char buffer[4];
-    itoa(vmcMode, buffer, 10);
-    mqttClient.publish(TOPIC_STATUS_VMC, buffer); 
-    mqttClient.publish(TOPIC_STATUS_CUISINE, gpioState(O_FOUR) ? "on" : "off"); 
-    switch (pacStatus) {
-      case PAC_STATUS_OFF  : mqttClient.publish(TOPIC_STATUS_PAC, S_OFF); break; 
-      case PAC_STATUS_OFFS : mqttClient.publish(TOPIC_STATUS_PAC, S_OFF_SHUTDOWN); break;
-      case PAC_STATUS_ON   : mqttClient.publish(TOPIC_STATUS_PAC, S_ON); break;
+  sprintf(buffer, "*;%lu;%lu;%lu;%lu;%lu", writes, bytes,
+          (unsigned long)flashWritesLastHour(), (unsigned long)stats.writeBudget,
+          (unsigned long)stats.throttled);
+  mqttClient.publish(TOPIC_FLASH_STATS, buffer);
+}
+
+//------------------  TOPIC_GET_MQTT_STATS ----------------------
+// ajoutés;remplacés;perdus;publiés;occupation max;en attente
+static void onGetMqttStats(const TopicPayload&) {
+  char buffer[80];
+  MqttQueueStats stats;
+  mqttQueueStatsTake(&stats);
+  sprintf(buffer, "%lu;%lu;%lu;%lu;%lu;%lu",
+          (unsigned long)stats.queued, (unsigned long)stats.coalesced,
+          (unsigned long)stats.dropped, (unsigned long)stats.published,
+          (unsigned long)stats.maxDepth, (unsigned long)stats.pending);
+  mqttClient.publish(TOPIC_MQTT_STATS, buffer);
+}
+
+//------------------  TOPIC_GET_NET_STATS ----------------------
+// état;coupures;reconnexions;tentatives WiFi;tentatives courtier;
+// durée dernière coupure (ms);durée max (ms);
+// connexions WiFi directes;échecs directs;recherches complètes;
+// durée connexion WiFi au démarrage (ms);durée dernière connexion WiFi (ms)
+static void onGetNetStats(const TopicPayload&) {
+  char buffer[160];
+  NetLinkStats stats;
+  WifiCacheStats wifiStats;
+  netLinkStatsTake(&stats);
+  wifiCacheStatsTake(&wifiStats);
+  sprintf(buffer, "%lu;%lu;%lu;%lu;%lu;%lu;%lu;%lu;%lu;%lu;%lu;%lu",
+          (unsigned long)stats.state, (unsigned long)stats.outages,
+          (unsigned long)stats.reconnects, (unsigned long)stats.wifiAttempts,
+          (unsigned long)stats.brokerAttempts, (unsigned long)stats.lastReconnect,
+          (unsigned long)stats.maxReconnect, (unsigned long)wifiStats.direct,
+          (unsigned long)wifiStats.directFailures, (unsigned long)wifiStats.scans,
+          (unsigned long)wifiStats.bootConnect, (unsigned long)wifiStats.lastConnect);
+  mqttClient.publish(TOPIC_NET_STATS, buffer);
+}
+
+//------------------  TOPIC_SET_FLASH_BUDGET ----------------------
+// Ecritures par heure au-delà desquelles les logs sont suspendus
+static void onSetFlashBudget(const TopicPayload& payload) {
+  flashSetBudget(payload.toInt());
+}
+
+//------------------  TOPIC_GET_PARAM_SCHEMA ----------------------
+// Un message par paramètre, dans l'ordre des chaines dly_param,
+// global_sched et des états persistants :
+// schéma;nom;type;min;max;défaut;persistance
+static void onGetParamSchema(const TopicPayload&) {
+  static const char* const types[] = { "int", "bool", "s" };
+  static const char* const persistences[] = { "config", "state" };
+  const ParamSchema* schemas[] = { &dlyParamSchema, &globalScheduledParamSchema, &persistantParamSchema };
+  char buffer[96];
+  for (const ParamSchema* schema : schemas) {
+    for (unsigned i = 0; i < schema->size; i++) {
+      const ParamField& field = schema->fields[i];
+      sprintf(buffer, "%s;%s;%s;%ld;%ld;%ld;%s", schema->name, field.name, types[field.type],
+              (long)field.min, (long)field.max, (long)field.def, persistences[field.persistence]);
+      mqttClient.publish(TOPIC_PARAM_SCHEMA, buffer);
     }
-    if (!erreurSupresseur && !erreurPompe)
-      mqttClient.publish(TOPIC_DEFAUT_SUPRESSOR, "off");
-    else if (erreurSupresseur)
-      mqttClient.publish(TOPIC_DEFAUT_SUPRESSOR, "on");
-    else
-      mqttClient.publish(TOPIC_DEFAUT_SUPRESSOR, "on2");             
-    return;
   }
-  //------------------  TOPIC_TEST_RESULT ----------------------
-  // if (cmp(topic, TOPIC_MQTT_TEST)) {
-  //   mqttConnect = true;   
-  //   // Serial.println("INTERVAL_MQTT_CONNECT_TEST_OK"); 
-  //   return;
-  // }
+}
+
+//------------------  TOPIC_TEST_RESULT ----------------------
+// if (cmp(topic, TOPIC_MQTT_TEST)) {
+//   mqttConnect = true;   
+//   // Serial.println("INTERVAL_MQTT_CONNECT_TEST_OK"); 
+//   return;
+// }
+
+/**
+ * @brief Topics d'abonnement et leur traitement
+ *        Triée sur le nom du topic (ordre vérifié à la compilation)
+ */
+static constexpr TopicHandler topicHandlers[] = {
+  { TOPIC_APP_CONNECT,        onAppConnect },
+  { TOPIC_CMD_ARROSAGE,       onCmdArrosage },
+  { TOPIC_CLEAR_LOGS,         onClearLogs },
+  { TOPIC_CMD_CUISINE,        onCmdCuisine },
+  { TOPIC_MQTT_GET_STATUS,    onMqttGetStatus },
+  { TOPIC_SET_FLASH_BUDGET,   onSetFlashBudget },
+  { TOPIC_GET_FLASH_STATS,    onGetFlashStats },
+  { TOPIC_GET_DLY_PARAM,      onGetDlyParam },
+  { TOPIC_GET_GPIO,           onGetGpio },
+  { TOPIC_GET_GLOBAL_SCHED,   onGetGlobalSched },
+  { TOPIC_WRITE_GLOBAL_SCHED, onWriteGlobalSched },
+  { TOPIC_GET_IO_STATS,       onGetIoStats },
+  { TOPIC_CMD_IRRIGATION,     onCmdIrrigation },
+  { TOPIC_LOGS_GET,           onLogsGet },
+  { TOPIC_GET_MQTT_STATS,     onGetMqttStats },
+  { TOPIC_GET_NET_STATS,      onGetNetStats },
+  { TOPIC_GET_NEXT_EVENT,     onGetNextEvent },
+  { TOPIC_CMD_PAC,            onCmdPac },
+  { TOPIC_GET_PARAM,          onGetParam },
+  { TOPIC_GET_PARAM_SCHEMA,   onGetParamSchema },
+  { TOPIC_GET_PROFILE,        onGetProfile },
+  { TOPIC_CMD_REAMORCER,      onCmdReamorcer },
+  { TOPIC_REBOOT,             onReboot },
+  { TOPIC_GET_SCAN_STATS,     onGetScanStats },
+  { TOPIC_CMD_VANNE_EST,      onCmdVanneEst },
+  { TOPIC_GET_VERSION,        onGetVersion },
+  { TOPIC_CMD_VMC,            onCmdVmc },
+  { TOPIC_WATCH_DOG_OFF,      onWatchDogOff },
+  { TOPIC_WRITE_DLY_PARAM,    onWriteDlyParam },
+  { TOPIC_WRITE_PARAM,        onWriteParam },
+};
+#define N_TOPIC_HANDLERS (sizeof(topicHandlers) / sizeof(topicHandlers[0]))
+static_assert(topicsSorted(topicHandlers, N_TOPIC_HANDLERS), "topicHandlers : ordre alphabétique ou préfixe TOPIC_ROOT");
+
+/**
+ * @brief Abonnement aux topics de topicHandlers
+ */
+void subscribeTopics() {
+  subscribeTopics(mqttClient, topicHandlers, N_TOPIC_HANDLERS);
+}
+
+/**
+ *@brief  Réception des messages MQTT
+ *        Attention si le buffer MQTT est trop petit le message correspondant est
+ *        supprimé. Voir commentaires en-tête de ce fichier
+ * 
+ * @param topic 
+ * @param payload 
+ * @param length 
+ */
+void PubSubCallback(char* topic, byte* payload, unsigned int length) {
+  // Vue sur le tampon de PubSubClient : pas de copie ni d'allocation
+  TopicPayload view = { (const char*)payload, length };
+
+#ifdef DEBUG_TOPIC
+  Serial.printf("%s : %.*s\n", topic, (int)length, view.data);
+#endif
+
+  const TopicHandler* handler = findTopic(topicHandlers, N_TOPIC_HANDLERS, topic);
+  if (handler)
+    handler->callback(view);
 }
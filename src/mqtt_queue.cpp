@@ -0,0 +1,110 @@
+/**
+ * @file mqtt_queue.cpp
+ * @brief Implementation de la file d'attente des publications MQTT.
+ */
+#include "mqtt_queue.h"
+
+/**
+ * @brief Topics d'état : seule la dernière valeur est publiée
+ */
+static const char* const statusTopics[] = {
+  TOPIC_STATUS_VMC,
+  TOPIC_STATUS_PAC,
+  TOPIC_STATUS_CUISINE,
+  TOPIC_STATUS_WATERING,
+  TOPIC_GPIO,
+  TOPIC_DEFAUT_SUPRESSOR,
+  TOPIC_SUPRESSOR_SECURITY,
+  TOPIC_NEXT_EVENT,
+};
+#define N_STATUS_TOPICS (sizeof(statusTopics) / sizeof(statusTopics[0]))
+
+struct MqttMessage {
+  const char* topic;
+  int status;  ///< Indice dans statusTopics, -1 pour un événement
+  char payload[MQTT_QUEUE_PAYLOAD];
+};
+
+// File circulaire : count messages à partir de head
+static MqttMessage queue[MQTT_QUEUE_SIZE];
+static unsigned head;
+static unsigned count;
+static MqttQueueStats stats;
+static portMUX_TYPE mqttMux = portMUX_INITIALIZER_UNLOCKED;
+
+static int statusIndex(const char* topic) {
+  for (unsigned i = 0; i < N_STATUS_TOPICS; i++)
+    if (topic == statusTopics[i] || strcmp(topic, statusTopics[i]) == 0)
+      return i;
+  return -1;
+}
+
+boolean mqttPublish(const char* topic, const char* payload) {
+  size_t length = strlen(payload);
+  int status = statusIndex(topic);
+  boolean ok = length < MQTT_QUEUE_PAYLOAD;
+  portENTER_CRITICAL(&mqttMux);
+  MqttMessage* message = NULL;
+  if (ok && status >= 0)
+    // Valeur d'état en attente : remplacée
+    for (unsigned i = 0; i < count && message == NULL; i++)
+      if (queue[(head + i) % MQTT_QUEUE_SIZE].status == status) {
+        message = &queue[(head + i) % MQTT_QUEUE_SIZE];
+        stats.coalesced++;
+      }
+  if (ok && message == NULL && count < MQTT_QUEUE_SIZE) {
+    message = &queue[(head + count++) % MQTT_QUEUE_SIZE];
+    message->topic = topic;
+    message->status = status;
+    stats.queued++;
+    if (count > stats.maxDepth)
+      stats.maxDepth = count;
+  }
+  if (message != NULL)
+    memcpy(message->payload, payload, length + 1);
+  else {
+    stats.dropped++;
+    ok = false;
+  }
+  portEXIT_CRITICAL(&mqttMux);
+  return ok;
+}
+
+void mqttQueueDrain(PubSubClient& client) {
+  MqttMessage message;
+  while (client.connected()) {
+    portENTER_CRITICAL(&mqttMux);
+    boolean empty = count == 0;
+    if (!empty) {
+      message = queue[head];
+      head = (head + 1) % MQTT_QUEUE_SIZE;
+      count--;
+    }
+    portEXIT_CRITICAL(&mqttMux);
+    if (empty)
+      return;
+    // Publication hors section critique
+    boolean ok = client.publish(message.topic, message.payload);
+    portENTER_CRITICAL(&mqttMux);
+    if (ok)
+      stats.published++;
+    else if (count < MQTT_QUEUE_SIZE) {
+      // Remis en tête, nouvel essai au prochain appel
+      head = (head + MQTT_QUEUE_SIZE - 1) % MQTT_QUEUE_SIZE;
+      queue[head] = message;
+      count++;
+    }
+    else
+      stats.dropped++;
+    portEXIT_CRITICAL(&mqttMux);
+    if (!ok)
+      return;
+  }
+}
+
+void mqttQueueStatsTake(MqttQueueStats* copy) {
+  portENTER_CRITICAL(&mqttMux);
+  *copy = stats;
+  copy->pending = count;
+  portEXIT_CRITICAL(&mqttMux);
+}
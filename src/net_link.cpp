@@ -0,0 +1,128 @@
+/**
+ * @file net_link.cpp
+ * @brief Implementation de l'automate de reconnexion WiFi / MQTT.
+ */
+#include "net_link.h"
+
+static PubSubClient* client;
+static const NetLinkConfig* config;
+static NetState state;
+static uint32_t since;        ///< Début de la coupure
+static uint32_t nextAttempt;  ///< Echéance de la prochaine tentative
+static uint32_t deadline;     ///< Fin de l'attente de la connexion WiFi
+static uint32_t backoff;      ///< Délai courant entre tentatives, 0 avant le premier échec
+static NetLinkStats stats;
+
+static boolean wifiUp() {
+  return WiFi.status() == WL_CONNECTED;
+}
+
+static boolean due(uint32_t now, uint32_t time) {
+  return (int32_t)(now - time) >= 0;
+}
+
+/**
+ * @brief Echec d'une tentative : délai doublé avec tirage aléatoire
+ * @param next état de la tentative suivante
+ */
+static void retry(NetState next, uint32_t now) {
+  backoff = backoff ? min(backoff * 2, (uint32_t)NET_BACKOFF_MAX) : NET_BACKOFF_MIN;
+  nextAttempt = now + backoff / 2 + random(backoff / 2 + 1);
+  state = next;
+}
+
+/**
+ * @brief Une tentative de connexion au courtier
+ */
+static boolean brokerConnect() {
+  // Pour un même courtier les clients doivent avoir un id différent
+  char clientId[20];
+  snprintf(clientId, sizeof(clientId), "ESP32Client-%lx", random(0xffff));
+  stats.brokerAttempts++;
+  return client->connect(clientId, config->mqttUser, config->mqttPassword);
+}
+
+void netLinkBegin(PubSubClient& mqttClient, const NetLinkConfig& netConfig, boolean connected) {
+  client = &mqttClient;
+  config = &netConfig;
+  backoff = 0;
+  since = nextAttempt = millis();
+  state = connected ? NET_UP : wifiUp() ? NET_BROKER : NET_WIFI_DOWN;
+  if (!connected)
+    stats.outages++;
+}
+
+NetState netLinkLoop() {
+  uint32_t now = millis();
+  switch (state) {
+    case NET_UP:
+      if (client->connected())
+        break;
+      stats.outages++;
+      since = nextAttempt = now;
+      backoff = 0;
+      state = wifiUp() ? NET_BROKER : NET_WIFI_DOWN;
+      break;
+    case NET_WIFI_DOWN:
+      // Reconnexion automatique du pilote WiFi
+      if (wifiUp()) {
+        wifiCacheConnected();
+        state = NET_BROKER;
+        break;
+      }
+      if (!due(now, nextAttempt))
+        break;
+      stats.wifiAttempts++;
+      deadline = now + (wifiCacheBegin(config->ssid, config->password) ? WIFI_DIRECT_TIMEOUT : NET_WIFI_TIMEOUT);
+      state = NET_WIFI_WAIT;
+      break;
+    case NET_WIFI_WAIT:
+      if (wifiUp()) {
+        wifiCacheConnected();
+        // Le courtier est tenté aussitôt, délai propre à ses échecs
+        backoff = 0;
+        nextAttempt = now;
+        state = NET_BROKER;
+      }
+      else if (due(now, deadline)) {
+        // Point d'accès mémorisé absent : recherche complète sans délai
+        if (wifiCacheFailed()) {
+          nextAttempt = now;
+          state = NET_WIFI_DOWN;
+        }
+        else
+          retry(NET_WIFI_DOWN, now);
+      }
+      break;
+    case NET_BROKER:
+      if (!wifiUp()) {
+        state = NET_WIFI_DOWN;
+        break;
+      }
+      if (!due(now, nextAttempt))
+        break;
+      if (brokerConnect())
+        state = NET_SUBSCRIBE;
+      else
+        retry(NET_BROKER, millis());
+      break;
+    case NET_SUBSCRIBE:
+      config->onSubscribe();
+      state = NET_RESYNC;
+      break;
+    case NET_RESYNC:
+      config->onResync();
+      stats.reconnects++;
+      stats.lastReconnect = now - since;
+      stats.maxReconnect = max(stats.maxReconnect, stats.lastReconnect);
+      backoff = 0;
+      state = NET_UP;
+      break;
+  }
+  return state;
+}
+
+void netLinkStatsTake(NetLinkStats* copy) {
+  *copy = stats;
+  copy->state = state;
+}
@@ -5,6 +5,22 @@
  */
 #include "param.h"
 
+// Toutes les plages à rendre
+#define ALL_RANGES ((uint32_t)((1ULL << N_PARAM) - 1))
+static_assert(N_PARAM <= 32, "_dirty : un bit par plage");
+
+static const char* const fieldNames[N_FIELDS] = { "enable", "HMin", "MMin", "HMax", "MMax" };
+// Valeur maximale de chaque champ (heures 0..23, minutes 0..59, enable 0..2)
+static const int fieldMax[N_FIELDS] = { 2, 23, 59, 23, 59 };
+
+/**
+ * @brief Valeur maximale d'un champ
+ *        HMax et MMax de l'irrigation : période et compteur de jours du circuit 2
+ */
+static int maxValue(int deviceId, int field) {
+  return (deviceId == IRRIGATION && field >= 3) ? MAX_DAYS_CIRCUIT2 : fieldMax[field];
+}
+
 /**
  * @brief Prints the ItemParam object in the format enable:HMin:MMin:HMax:MMax.
  */
@@ -19,14 +35,18 @@ void ItemParam::print() {
  * @param param The parameter string to initialize the object with.
  */
 Param::Param(const char* param) {
-  strcpy(_sparam, param);
-  setParam();
+  _version = 0;
+  _error[0] = '\0';
+  // En cas d'erreur : toutes les plages désactivées
+  _dirty = ALL_RANGES;
+  setStr(param);
 }
 
 /**
  * Print on serial param data
  */
 void Param::printStrParam() {   
+  getStr();
   int j = 1;
   for (int i = 0; i < N_DEVICES * TAILLE_PLAGE * N_PLAGES - 1; i++) {
     Serial.print(_sparam[i]);
@@ -59,7 +79,34 @@ ItemParam Param::get(int numParam, int timeSet) {
  * @param itemParam item de la forme 0:00:00:00:00
  */
 void Param::set(int numParam, int timeSet, const ItemParam itemParam) {
-  _param[(numParam * N_PLAGES) + timeSet] = itemParam;
+  int i = (numParam * N_PLAGES) + timeSet;
+  ItemParam& item = _param[i];
+  if (item.enable == itemParam.enable && item.HMin == itemParam.HMin && item.MMin == itemParam.MMin &&
+      item.HMax == itemParam.HMax && item.MMax == itemParam.MMax)
+    return;
+  item = itemParam;
+  _dirty |= 1UL << i;
+  _version++;
+}
+
+/**
+ *@brief Ecrit la plage i dans son emplacement de _sparam : "e:hh:mm:hh:mm:"
+ *       (TAILLE_PLAGE caractères, ':' final remplacé par '\0' pour la dernière plage)
+ *       Les valeurs ont été validées (deux chiffres au plus).
+ * 
+ * @param i numéro de la plage 0..N_PARAM-1
+ */
+void Param::render(int i) {
+  char* p = _sparam + i * TAILLE_PLAGE;
+  const ItemParam& item = _param[i];
+  const int values[4] = { item.HMin, item.MMin, item.HMax, item.MMax };
+  *p++ = '0' + item.enable;
+  for (int f = 0; f < 4; f++) {
+    *p++ = ':';
+    *p++ = '0' + values[f] / 10;
+    *p++ = '0' + values[f] % 10;
+  }
+  *p = (i == N_PARAM - 1) ? '\0' : ':';
 }
 
 /*
@@ -67,62 +114,138 @@ void Param::set(int numParam, int timeSet, const ItemParam itemParam) {
   A partir de sa repésentaion sous forme de chaines
   0:00:00:00:00:0:00:00:00:00:0:00:00:00:00...
   <---Plage---> <---Plage---> <---Plage--->...
+  Lecture en une passe, sans allocation. En cas d'erreur, param n'est pas
+  modifié et _error indique la plage et le champ en cause.
 */
-void Param::setParam() {
-  String str(_sparam);
-  int index = -1;
+boolean Param::parse(const char* str, ItemParam* param) {
+  ItemParam items[N_PARAM];
+  const char* p = str;
   for (int i = 0; i < N_PARAM; i++) {
-    str = str.substring(index + 1);
-    index = str.indexOf(':');
-    _param[i].enable = atoi(str.substring(0,index).c_str());
-    str = str.substring(index + 1);
-    index = str.indexOf(':');
-    _param[i].HMin = atoi(str.substring(0,index).c_str());
-    str = str.substring(index + 1);
-    index = str.indexOf(':');
-    _param[i].MMin = atoi(str.substring(0,index).c_str());
-    str = str.substring(index + 1);
-    index = str.indexOf(':');
-    _param[i].HMax = atoi(str.substring(0,index).c_str());
-    str = str.substring(index + 1);
-    index = str.indexOf(':');
-    _param[i].MMax = atoi(str.substring(0,index).c_str());
+    int* fields[N_FIELDS] = { &items[i].enable, &items[i].HMin, &items[i].MMin,
+                              &items[i].HMax, &items[i].MMax };
+    int deviceId = i / N_PLAGES;
+    for (int f = 0; f < N_FIELDS; f++) {
+      const char* reason = NULL;
+      int value = 0;
+      if (i + f > 0 && *p++ != ':')
+        reason = "':' attendu";
+      else if (*p < '0' || *p > '9')
+        reason = "nombre attendu";
+      else {
+        for (int digits = 0; *p >= '0' && *p <= '9'; digits++, p++) {
+          if (digits == 2) {
+            reason = "trop de chiffres";
+            break;
+          }
+          value = value * 10 + (*p - '0');
+        }
+        if (reason == NULL && value > maxValue(deviceId, f))
+          reason = "hors limites";
+      }
+      if (reason != NULL) {
+        snprintf(_error, sizeof(_error), "Param dev %d plage %d %s : %s",
+                 deviceId, i % N_PLAGES, fieldNames[f], reason);
+        return false;
+      }
+      *fields[f] = value;
+    }
   }
+  // Tolérance : ':' final, fin de ligne
+  if (*p == ':')
+    p++;
+  while (*p == '\r' || *p == '\n' || *p == ' ')
+    p++;
+  if (*p != '\0') {
+    snprintf(_error, sizeof(_error), "Param : caractères en trop (position %d)", (int)(p - str));
+    return false;
+  }
+  memcpy(param, items, sizeof(items));
+  _error[0] = '\0';
+  return true;
+}
+
+boolean Param::setParam() {
+  if (!parse(_sparam, _param))
+    return false;
+  // Chaine réécrite sous forme normalisée (emplacements de largeur fixe)
+  _dirty = ALL_RANGES;
+  _version++;
+  return true;
+}
+
+void Param::pack(uint8_t* data) {
+  for (int i = 0; i < N_PARAM; i++) {
+    *data++ = _param[i].enable;
+    *data++ = _param[i].HMin;
+    *data++ = _param[i].MMin;
+    *data++ = _param[i].HMax;
+    *data++ = _param[i].MMax;
+  }
+}
+
+/**
+ *@brief Initialise les plages à partir de leur représentation binaire
+ *       La chaine des paramètres (protocole MQTT) est reconstruite.
+ *
+ * @param data données écrites par pack()
+ * @param size taille des données
+ * @return true si les données sont valides
+ */
+boolean Param::unpack(const uint8_t* data, size_t size) {
+  if (size != PARAM_RECORD_SIZE) {
+    snprintf(_error, sizeof(_error), "Param : taille %d, %d attendue", (int)size, PARAM_RECORD_SIZE);
+    return false;
+  }
+  for (int i = 0; i < PARAM_RECORD_SIZE; i++) {
+    int deviceId = i / (N_FIELDS * N_PLAGES);
+    if (data[i] > maxValue(deviceId, i % N_FIELDS)) {
+      snprintf(_error, sizeof(_error), "Param dev %d plage %d %s : hors limites",
+               deviceId, (i / N_FIELDS) % N_PLAGES, fieldNames[i % N_FIELDS]);
+      return false;
+    }
+  }
+  for (int i = 0; i < N_PARAM; i++) {
+    _param[i].enable = *data++;
+    _param[i].HMin = *data++;
+    _param[i].MMin = *data++;
+    _param[i].HMax = *data++;
+    _param[i].MMax = *data++;
+  }
+  _dirty = ALL_RANGES;
+  _error[0] = '\0';
+  _version++;
+  return true;
 }
 
 /**
  *@brief Initialise la chaine des paramètres à partir d'une autre chaine
-         Met à jour l'objet
+         Met à jour l'objet. Les paramètres courants sont conservés si
+         la chaine est invalide.
  *
  * @param str chaine d'init
+ * @return true si la chaine est valide
  */
-void  Param::setStr(const char* str) {
-  strcpy(_sparam, str);
-  setParam();
+boolean Param::setStr(const char* str) {
+  if (strlen(str) >= sizeof(_sparam)) {
+    snprintf(_error, sizeof(_error), "Param : chaine trop longue (%d)", (int)strlen(str));
+    return false;
+  }
+  if (!parse(str, _param))
+    return false;
+  // Chaine réécrite sous forme normalisée (emplacements de largeur fixe)
+  _dirty = ALL_RANGES;
+  _version++;
+  return true;
 }
 /**
- *@brief Met à jour la chaine param avec le contenu de l'objet correspond
- *       Utilisation updateStringParam(cParam->getStr())
+ *@brief Copie la chaine param correspondant au contenu de l'objet
  *
  * @param param chaine à initialiser
  */
 void Param::updateStringParam(char* param) {
-  char buffer[60];
-  param[0] = '\0';
-  for (int i = 0; i < N_DEVICES; i++) {
-    for (int j = 0; j < N_PLAGES; j++) {
-      ItemParam   itemParam = get(i, j);
-      sprintf(buffer,"%d:%02d:%02d:%02d:%02d:",
-        itemParam.enable,
-        itemParam.HMin,
-        itemParam.MMin,
-        itemParam.HMax,
-        itemParam.MMax);
-      strcat(param,buffer);
-    }
-  }
-  // Supprimer le ':' en fin de chaine
-  *(param + strlen(param) - 1) = '\0';
+  char* str = getStr();
+  if (param != str)
+    strcpy(param, str);
 }
 
 /**
@@ -131,6 +254,10 @@ void Param::updateStringParam(char* param) {
  * @return char* chaine des paramètres
  */
 char* Param::getStr() {
+  // Rendu paresseux : seules les plages modifiées depuis le dernier appel
+  for (int i = 0; _dirty != 0; i++, _dirty >>= 1)
+    if (_dirty & 1)
+      render(i);
   return _sparam;
 }
 /**
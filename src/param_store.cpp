@@ -0,0 +1,201 @@
+/**
+ * @file param_store.cpp
+ * @brief Implementation de la mémorisation binaire des paramètres.
+ *
+ * Enregistrement différé : chaque jeu de paramètres simples a un indicateur
+ * de modification et la date de la première modification non enregistrée.
+ * Les valeurs sont copiées en section critique puis écrites hors section
+ * critique ; une modification pendant l'écriture relance l'indicateur.
+ * persistMutex sérialise les écritures de la tâche et de persistFlush().
+ */
+#include "param_store.h"
+#include "logs.h"
+
+// Jeux de paramètres simples enregistrés en différé
+#define MAX_PERSIST_SETS 4
+
+struct PersistSet {
+  FileLittleFS* file;
+  SimpleParam* param;
+  boolean dirty;
+  unsigned long since;  ///< millis() de la première modification non enregistrée
+};
+
+static PersistSet persistSets[MAX_PERSIST_SETS];
+static int nPersistSets;
+static boolean persistStarted;
+static SemaphoreHandle_t persistMutex;
+static portMUX_TYPE persistMux = portMUX_INITIALIZER_UNLOCKED;
+
+boolean saveParam(FileLittleFS* file, Param* param) {
+  uint8_t data[PARAM_RECORD_SIZE];
+  param->pack(data);
+  return file->writeRecord(RECORD_FORMAT_ITEMS, data, sizeof(data));
+}
+
+boolean saveParam(FileLittleFS* file, SimpleParam* param) {
+  int32_t data[MAX_SCHEMA_FIELDS];
+  for (unsigned i = 0; i < param->size(); i++)
+    data[i] = param->get(i);
+  return file->writeRecord(RECORD_FORMAT_INTS, data, param->size() * sizeof(int32_t));
+}
+
+void persistParam(FileLittleFS* file, SimpleParam* param) {
+  if (!persistStarted) {
+    saveParam(file, param);
+    return;
+  }
+  portENTER_CRITICAL(&persistMux);
+  int i = 0;
+  while (i < nPersistSets && persistSets[i].param != param)
+    i++;
+  if (i == nPersistSets && nPersistSets < MAX_PERSIST_SETS)
+    persistSets[nPersistSets++] = { file, param, false, 0 };
+  PersistSet* set = i < nPersistSets ? &persistSets[i] : NULL;
+  if (set && !set->dirty) {
+    set->dirty = true;
+    set->since = millis();
+  }
+  portEXIT_CRITICAL(&persistMux);
+  // Plus de MAX_PERSIST_SETS jeux : pas de regroupement
+  if (set == NULL)
+    saveParam(file, param);
+}
+
+/**
+ * @brief Enregistre les jeux modifiés
+ * @param all true : tous, false : ceux dont la fenêtre est écoulée
+ */
+static void persistWrite(boolean all) {
+  if (persistMutex)
+    xSemaphoreTake(persistMutex, portMAX_DELAY);
+  for (int i = 0; i < nPersistSets; i++) {
+    PersistSet* set = &persistSets[i];
+    int32_t data[MAX_SCHEMA_FIELDS];
+    unsigned size = set->param->size();
+    portENTER_CRITICAL(&persistMux);
+    boolean due = set->dirty && (all || millis() - set->since >= PERSIST_WINDOW);
+    if (due) {
+      set->dirty = false;
+      for (unsigned j = 0; j < size; j++)
+        data[j] = set->param->get(j);
+    }
+    portEXIT_CRITICAL(&persistMux);
+    if (due)
+      set->file->writeRecord(RECORD_FORMAT_INTS, data, size * sizeof(int32_t));
+  }
+  if (persistMutex)
+    xSemaphoreGive(persistMutex);
+}
+
+void persistPoll() {
+  persistWrite(false);
+}
+
+void persistFlush() {
+  persistWrite(true);
+  FileLittleFS::syncAll();
+}
+
+#ifdef PERSIST_TASK
+/**
+ * @brief Tâche d'enregistrement différé
+ */
+static void persistTaskCode(void*) {
+  for (;;) {
+    vTaskDelay(pdMS_TO_TICKS(INTERVAL_PERSIST_POLL));
+    persistPoll();
+  }
+}
+#endif
+
+void persistInit() {
+  if (persistStarted)
+    return;
+  persistMutex = xSemaphoreCreateMutex();
+  persistStarted = true;
+#ifdef PERSIST_TASK
+  xTaskCreatePinnedToCore(persistTaskCode, "persist", PERSIST_TASK_STACK, NULL,
+                          PERSIST_TASK_PRIORITY, NULL, PERSIST_TASK_CORE);
+#endif
+}
+
+/**
+ * @brief Lecture de l'ancien fichier texte
+ * @return String vide si le fichier n'existe pas
+ */
+static String readTextFile(const char* textName) {
+  if (!FileLittleFS::exist(textName))
+    return String();
+  FileLittleFS textFile(textName);
+  String text = textFile.readFile();
+  textFile.close();
+  return text;
+}
+
+/**
+ * @brief Journalisation d'un fichier remplacé
+ */
+static void logFile(const char* message, const char* name) {
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "%s %s", message, name);
+  logsWrite(buffer);
+}
+
+/**
+ * @brief Enregistrement binaire des valeurs courantes, suppression de l'ancien fichier texte
+ */
+template <class T>
+static FileLittleFS* rewrite(FileLittleFS* file, const char* textName, T* param) {
+  saveParam(file, param);
+  if (FileLittleFS::exist(textName))
+    FileLittleFS::rmFile(textName);
+  return file;
+}
+
+FileLittleFS* openParam(const char* name, const char* textName, Param* param, boolean force) {
+  auto* file = new FileLittleFS(name);
+  if (force)
+    return rewrite(file, textName, param);
+  uint8_t data[PARAM_RECORD_SIZE];
+  int size = file->readRecord(RECORD_FORMAT_ITEMS, data, sizeof(data));
+  if (size >= 0 && param->unpack(data, size)) {
+    if (file->recovered())
+      logFile("Reprise copie temporaire", name);
+    return file;
+  }
+  if (file->exist())
+    logFile("Fichier invalide", name);
+  String text = readTextFile(textName);
+  if (text.length() > 0) {
+    if (param->setStr(text.c_str()))
+      logFile("Migration", textName);
+    else
+      logsWrite(param->error());
+  }
+  return rewrite(file, textName, param);
+}
+
+FileLittleFS* openParam(const char* name, const char* textName, SimpleParam* param, boolean force) {
+  auto* file = new FileLittleFS(name);
+  if (force)
+    return rewrite(file, textName, param);
+  int32_t data[MAX_SCHEMA_FIELDS];
+  int size = file->readRecord(RECORD_FORMAT_INTS, data, sizeof(data));
+  if (size >= 0 && size % sizeof(int32_t) == 0) {
+    param->setValues(data, size / sizeof(int32_t));
+    if (file->recovered())
+      logFile("Reprise copie temporaire", name);
+    return file;
+  }
+  if (file->exist())
+    logFile("Fichier invalide", name);
+  String text = readTextFile(textName);
+  if (text.length() > 0) {
+    if (param->setStr(text.c_str(), true))
+      logFile("Migration", textName);
+    else
+      logsWrite(param->error());
+  }
+  return rewrite(file, textName, param);
+}
@@ -0,0 +1,46 @@
+/**
+ * @file profile.cpp
+ * @brief Histogrammes des durées d'exécution par section.
+ *
+ * Les mesures proviennent de loop() (coeur 1), de la tâche de scrutation
+ * (coeur 0) et des écritures LittleFS : la mise à jour est protégée par
+ * un spinlock.
+ */
+#include "profile.h"
+#include <string.h>
+
+// Bornes supérieures des classes (us), la dernière classe est ouverte
+static const unsigned long bucketLimits[PROF_N_BUCKETS - 1] = {
+  100, 500, 1000, 5000, 10000, 50000, 100000
+};
+
+static const char* const sectionNames[PROF_N_SECTIONS] = {
+  "loop", "mqtt", "alexa", "local", "sched", "disp", "fs", "jitter"
+};
+
+static portMUX_TYPE profMux = portMUX_INITIALIZER_UNLOCKED;
+static ProfHistogram histograms[PROF_N_SECTIONS];
+
+void profRecord(ProfSection section, unsigned long us) {
+  int bucket = 0;
+  while (bucket < PROF_N_BUCKETS - 1 && us >= bucketLimits[bucket])
+    bucket++;
+  portENTER_CRITICAL(&profMux);
+  ProfHistogram* h = &histograms[section];
+  h->count++;
+  h->buckets[bucket]++;
+  if (us > h->maxUs)
+    h->maxUs = us;
+  portEXIT_CRITICAL(&profMux);
+}
+
+void profTake(ProfHistogram* copy) {
+  portENTER_CRITICAL(&profMux);
+  memcpy(copy, histograms, sizeof(histograms));
+  memset(histograms, 0, sizeof(histograms));
+  portEXIT_CRITICAL(&profMux);
+}
+
+const char* profName(int section) {
+  return section >= 0 && section < PROF_N_SECTIONS ? sectionNames[section] : "";
+}
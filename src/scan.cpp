@@ -0,0 +1,101 @@
+/**
+ * @file scan.cpp
+ * @brief Cycle de scrutation à période fixe et mesure de sa durée.
+ *
+ * La tâche se réveille par vTaskDelayUntil() : la période ne dérive pas avec
+ * la durée du cycle. La gigue mesurée est l'écart entre deux débuts de cycle
+ * et la période INTERVAL_IO_SCRUT.
+ */
+#include "scan.h"
+#include "io.h"
+#include "profile.h"
+#include <esp_task_wdt.h>
+#include <limits.h>
+
+extern void localLoop();
+
+static SemaphoreHandle_t ctrlMutex;
+static TaskHandle_t scanTask;
+
+// Statistiques partagées entre le cycle et la lecture (MQTT)
+static portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+static ScanStats stats = {0, ULONG_MAX, 0, 0, 0, 0};
+
+void ctrlLock() {
+  if (ctrlMutex)
+    xSemaphoreTakeRecursive(ctrlMutex, portMAX_DELAY);
+}
+
+void ctrlUnlock() {
+  if (ctrlMutex)
+    xSemaphoreGiveRecursive(ctrlMutex);
+}
+
+void scanCycle() {
+  static unsigned long lastStart;
+  unsigned long start = micros();
+  {
+    CtrlGuard guard;
+    ProfTimer timer(PROF_LOCAL_LOOP);
+    localLoop();
+  }
+  // Seule écriture des registres de sortie
+  ioFlush();
+  unsigned long duration = micros() - start;
+
+  // Ecart entre deux débuts de cycle et la période (pas de mesure au premier cycle)
+  unsigned long jitter = 0;
+  if (lastStart != 0) {
+    long delta = (long)(start - lastStart) - INTERVAL_IO_SCRUT * 1000L;
+    jitter = delta < 0 ? -delta : delta;
+    profRecord(PROF_SCAN_JITTER, jitter);
+  }
+  lastStart = start;
+
+  portENTER_CRITICAL(&statsMux);
+  if (jitter > stats.maxJitterUs)
+    stats.maxJitterUs = jitter;
+  stats.scans++;
+  stats.sumUs += duration;
+  if (duration < stats.minUs)
+    stats.minUs = duration;
+  if (duration > stats.maxUs)
+    stats.maxUs = duration;
+  if (duration > INTERVAL_IO_SCRUT * 1000UL)
+    stats.overruns++;
+  portEXIT_CRITICAL(&statsMux);
+}
+
+void scanStatsTake(ScanStats* copy) {
+  portENTER_CRITICAL(&statsMux);
+  *copy = stats;
+  stats = {0, ULONG_MAX, 0, 0, 0, 0};
+  portEXIT_CRITICAL(&statsMux);
+  if (copy->scans == 0)
+    copy->minUs = 0;
+}
+
+/**
+ * @brief Tâche de scrutation à période fixe
+ */
+static void scanTaskCode(void*) {
+#ifdef ENABLE_WATCHDOG
+  esp_task_wdt_add(NULL);
+#endif
+  TickType_t lastWake = xTaskGetTickCount();
+  for (;;) {
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(INTERVAL_IO_SCRUT));
+    scanCycle();
+#ifdef ENABLE_WATCHDOG
+    esp_task_wdt_reset();
+#endif
+  }
+}
+
+void initScanTask() {
+  if (scanTask)
+    return;
+  ctrlMutex = xSemaphoreCreateRecursiveMutex();
+  xTaskCreatePinnedToCore(scanTaskCode, "scan", SCAN_TASK_STACK, NULL,
+                          SCAN_TASK_PRIORITY, &scanTask, SCAN_TASK_CORE);
+}
@@ -0,0 +1,151 @@
+/**
+ * @file schedule.cpp
+ * @brief Implementation de la table précompilée des actions programmées.
+ *
+ * La table est construite une fois à chaque modification des paramètres :
+ * - une mise sous tension (HMin:MMin) et une mise hors tension (HMax:MMax) par plage active,
+ * - les événements sont triés par minute du jour, l'ordre d'origine
+ *   (dispositif, plage, mise sous tension avant mise hors tension) est conservé
+ *   pour les événements de la même minute.
+ *
+ * schedule() appelle pop() jusqu'à obtenir NULL : chaque appel se limite à
+ * l'avancement d'un curseur.
+ */
+#include "schedule.h"
+
+#define RTC_SCHEDULE_MAGIC 0x5C4ED001
+
+/**
+ * @brief Dernière minute évaluée par schedule()
+ *        Non initialisée au démarrage : conservée lors d'un redémarrage logiciel,
+ *        invalide (magic/check) après une mise sous tension.
+ */
+RTC_NOINIT_ATTR static struct {
+  uint32_t magic;
+  uint32_t epoch;
+  int32_t  lastMinute;
+  uint32_t check;
+} rtcSchedule;
+
+Schedule::Schedule() {
+  _nEvents = 0;
+  _cursor = 0;
+  _lastMinute = -1;
+  _version = 0;
+  _compiled = false;
+}
+
+/**
+ * @brief Ajoute un événement en conservant le tri par minute (tri par insertion stable)
+ */
+static void addEvent(ScheduleEvent* events, int& nEvents, int h, int m,
+                     int deviceId, int timeSet, int action, int enable) {
+  // Une heure invalide ne correspond à aucune minute du jour
+  if (h < 0 || h > 23 || m < 0 || m > 59 || nEvents >= MAX_SCHEDULE_EVENTS)
+    return;
+  uint16_t minute = h * 60 + m;
+  int i = nEvents;
+  while (i > 0 && events[i - 1].minute > minute) {
+    events[i] = events[i - 1];
+    i--;
+  }
+  events[i].minute = minute;
+  events[i].deviceId = deviceId;
+  events[i].timeSet = timeSet;
+  events[i].action = action;
+  events[i].enable = enable;
+  nEvents++;
+}
+
+void Schedule::compile(Param* param) {
+  _nEvents = 0;
+  for (int deviceId = 0; deviceId < N_DEVICES; deviceId++) {
+    for (int timeSet = 0; timeSet < N_PLAGES; timeSet++) {
+      ItemParam item = param->get(deviceId, timeSet);
+      if (item.enable == 0)
+        continue;
+      addEvent(_events, _nEvents, item.HMin, item.MMin, deviceId, timeSet, SCHED_ON, item.enable);
+      // La durée du remplissage du réservoir est gérée par un monostable,
+      // HMax et MMax sont utilisés par le circuit2
+      if (deviceId != IRRIGATION)
+        addEvent(_events, _nEvents, item.HMax, item.MMax, deviceId, timeSet, SCHED_OFF, item.enable);
+    }
+  }
+  _version = param->version();
+  _compiled = true;
+  seek(_lastMinute);
+#ifdef DEBUG_OUTPUT_SCHEDULE
+  print();
+#endif
+}
+
+void Schedule::update(Param* param) {
+  if (!_compiled || param->version() != _version)
+    compile(param);
+}
+
+void Schedule::seek(int minuteOfDay) {
+  _lastMinute = minuteOfDay;
+  _cursor = 0;
+  while (_cursor < _nEvents && _events[_cursor].minute <= _lastMinute)
+    _cursor++;
+}
+
+void Schedule::save(unsigned long epoch) {
+  rtcSchedule.magic = RTC_SCHEDULE_MAGIC;
+  rtcSchedule.epoch = epoch;
+  rtcSchedule.lastMinute = _lastMinute;
+  rtcSchedule.check = RTC_SCHEDULE_MAGIC ^ rtcSchedule.epoch ^ (uint32_t)rtcSchedule.lastMinute;
+}
+
+boolean Schedule::restore(unsigned long epoch) {
+  if (rtcSchedule.magic != RTC_SCHEDULE_MAGIC ||
+      rtcSchedule.check != (RTC_SCHEDULE_MAGIC ^ rtcSchedule.epoch ^ (uint32_t)rtcSchedule.lastMinute))
+    return false;
+  if (rtcSchedule.lastMinute < -1 || rtcSchedule.lastMinute >= MINUTES_PER_DAY)
+    return false;
+  // Horloge non cohérente ou arrêt trop long : pas de rattrapage
+  if (epoch < rtcSchedule.epoch || epoch - rtcSchedule.epoch > MAX_CATCH_UP_MINUTES * 60UL)
+    return false;
+  seek(rtcSchedule.lastMinute);
+  return true;
+}
+
+const ScheduleEvent* Schedule::pop(int minuteOfDay) {
+  if (minuteOfDay < _lastMinute) {
+    // Petit recul de l'horloge (mise à l'heure NTP) : pas de rejeu
+    if (_lastMinute - minuteOfDay < MINUTES_PER_DAY / 2) {
+      seek(minuteOfDay);
+      return NULL;
+    }
+    // Passage à minuit : terminer la journée précédente
+    if (_cursor < _nEvents)
+      return &_events[_cursor++];
+    _cursor = 0;
+    _lastMinute = -1;
+  }
+  if (_cursor < _nEvents && _events[_cursor].minute <= minuteOfDay)
+    return &_events[_cursor++];
+  _lastMinute = minuteOfDay;
+  return NULL;
+}
+
+const ScheduleEvent* Schedule::next() {
+  if (_nEvents == 0)
+    return NULL;
+  // Après le dernier événement de la journée, le suivant est le premier du lendemain
+  return &_events[_cursor < _nEvents ? _cursor : 0];
+}
+
+void Schedule::print() {
+  for (int i = 0; i < _nEvents; i++) {
+    Serial.printf("%c%02d:%02d dev=%d plage=%d %s (%d)\n",
+      i == _cursor ? '>' : ' ',
+      _events[i].minute / 60,
+      _events[i].minute % 60,
+      _events[i].deviceId,
+      _events[i].timeSet,
+      _events[i].action == SCHED_ON ? "on" : "off",
+      _events[i].enable);
+  }
+}
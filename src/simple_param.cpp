@@ -1,5 +1,3 @@
-
-
 /**
  * @file simple_param.cpp
  * @brief Implementation of the SimpleParam class for handling and manipulating parameter strings.
@@ -7,75 +5,26 @@
 
 #include "simple_param.h"
 
-/**
- * @brief Splits the parameter string _sparam into individual integer parameters.
- * 
- * This function modifies the source string by using strtok to tokenize the string
- * based on the specified motif. The tokens are then converted to integers and stored
- * in the _param array.
- */
-void SimpleParam::split() {
-  // !!!! strok modifie la chaine source
-  strcpy(_buffer, _sparam);
-  char* ptr;
-  int count = 0;
-  ptr = strtok(_buffer, _motif); // diviser la chaîne
-  while (ptr != NULL) {
-    _param[count] = atoi(ptr);
-    count++;
-    ptr = strtok(NULL, _motif);
-    if (count == _nparam) {
-      break;
-    }
-  }
-}
-
 /**
  * @brief Constructs a SimpleParam object.
  * 
- * @param initStr Initial parameter string.
- * @param motif Delimiter used to split the parameter string.
- * @param nParam Number of parameters expected.
+ * @param schema Description of the parameters.
  * 
- * This constructor initializes the SimpleParam object by allocating memory for the
- * motif, parameter string, buffer, and parameter array. It then copies the initial
- * strings and splits the parameter string into individual parameters.
+ * Every parameter is initialised with the default value of the schema.
  */
-SimpleParam::SimpleParam(const char* initStr, const char* motif, unsigned nParam) {
-  _nparam = nParam;
-  _motif = new char[strlen(motif) + 1];
-  _sparam = new char[strlen(initStr) + 1];
-  _buffer = new char[strlen(initStr) + 1];
-  _param = new int[nParam];
-
- // _motif =  (char*)malloc(strlen(motif) + 1);
- // _sparam = (char*)malloc(strlen(initStr) + 1);
- // _buffer = (char*)malloc(strlen(initStr) + 1);
- // _param  = (int*)malloc((sizeof(int) * nParam));
-  strcpy(_motif, motif);
-  strcpy(_sparam, initStr);
-  split();
+SimpleParam::SimpleParam(const ParamSchema& schema) : _schema(schema) {
+  for (unsigned i = 0; i < _schema.size; i++)
+    _param[i] = _schema.fields[i].def;
+  _dirty = true;
+  _error[0] = '\0';
 }
 
 /**
- * @brief Destructor for the SimpleParam class.
- * 
- * This destructor frees the allocated memory for the motif, parameter string, buffer,
- * and parameter array, and sets the pointers to NULL.
+ * @brief Brings a value within the bounds of the schema.
  */
-SimpleParam::~SimpleParam() {
-  delete  _motif;
-  delete  _sparam;
-  delete  _buffer;
-  delete  _param;
- // free(_motif);
- // free(_sparam);
- // free(_buffer);
- // free(_param);
-  _motif = NULL;
-  _sparam = NULL;
-  _buffer = NULL;
-  _param = NULL; 
+int32_t SimpleParam::clampValue(int numParam, int32_t val) {
+  const ParamField& field = _schema.fields[numParam];
+  return constrain(val, field.min, field.max);
 }
 
 /**
@@ -91,35 +40,13 @@ int SimpleParam::get(int numParam) {
  * @brief Sets the value of a specific parameter.
  * 
  * @param numParam Index of the parameter to set.
- * @param val Value to set the parameter to.
+ * @param val Value to set the parameter to, brought within the bounds of the schema.
  * 
- * This function sets the value of the specified parameter and updates the parameter
- * string to reflect the new value.
+ * The parameter string is rendered on the next call to getStr().
  */
 void SimpleParam::set(int numParam, int val) {
-  _param[numParam] = val;
-  update();
-}
-/**
- * @brief Updates the parameter string based on the current parameter values.
- * 
- * @return int Always returns 0.
- * 
- * This function constructs the parameter string by concatenating the individual
- * parameter values, separated by the motif.
- */
-int SimpleParam::update() {
-  char bufferItoa[6];
-  unsigned i = 0;
-  _buffer[0] = '\0';
-  for (; i < _nparam - 1; i++) {
-    strcat(_buffer, itoa(get(i), bufferItoa, 10));
-    strcat(_buffer, ":");
-  }
-  strcat(_buffer, itoa(get(i), bufferItoa, 10));
-  // Serial.println(buffer);
-  strcpy(_sparam, _buffer);
-  return 0;
+  _param[numParam] = clampValue(numParam, val);
+  _dirty = true;
 }
 /**
  * @brief Gets the parameter string.
@@ -127,32 +54,102 @@ int SimpleParam::update() {
  * @return char* Pointer to the parameter string.
  */
 char* SimpleParam::getStr() {
+  if (_dirty) {
+    char* p = _sparam;
+    for (unsigned i = 0; i < _schema.size; i++) {
+      if (i > 0)
+        *p++ = ':';
+      ltoa(_param[i], p, 10);
+      p += strlen(p);
+    }
+    *p = '\0';
+    _dirty = false;
+  }
   return _sparam;
 }
 /**
- * @brief Sets the parameter string.
+ * @brief Sets the parameters from a string "v0:v1:..." in a single pass.
  * 
  * @param str New parameter string.
- * 
- * This function sets the parameter string to the specified value and splits it into
- * individual parameters.
+ * @param clamp Bring values within bounds and accept missing trailing values.
+ * @return true if the string is valid; the current values are kept otherwise.
  */
-void  SimpleParam::setStr(const char* str) {
-  strcpy(_sparam, str);
-  split();
+boolean SimpleParam::setStr(const char* str, boolean clamp) {
+  int32_t values[MAX_SCHEMA_FIELDS];
+  const char* p = str;
+  unsigned n = 0;
+  const char* reason = NULL;
+  while (n < _schema.size) {
+    if (n > 0 && *p++ != ':') {
+      reason = *(p - 1) == '\0' ? "valeur manquante" : "':' attendu";
+      break;
+    }
+    boolean negative = (*p == '-');
+    if (negative)
+      p++;
+    if (*p < '0' || *p > '9') {
+      reason = "nombre attendu";
+      break;
+    }
+    int32_t value = 0;
+    for (; *p >= '0' && *p <= '9' && reason == NULL; p++) {
+      if (value > 99999999)
+        reason = "trop de chiffres";
+      value = value * 10 + (*p - '0');
+    }
+    if (reason != NULL)
+      break;
+    if (negative)
+      value = -value;
+    const ParamField& field = _schema.fields[n];
+    if (value < field.min || value > field.max) {
+      if (!clamp) {
+        reason = "hors limites";
+        break;
+      }
+      value = clampValue(n, value);
+    }
+    values[n++] = value;
+    // Anciens fichiers : paramètres ajoutés depuis absents
+    if (clamp && *p != ':')
+      break;
+  }
+  // Tolérance : fin de ligne
+  while (reason == NULL && (*p == '\r' || *p == '\n' || *p == ' '))
+    p++;
+  if (reason == NULL && *p != '\0')
+    reason = n < _schema.size ? "valeur manquante" : "caractères en trop";
+  if (reason != NULL) {
+    snprintf(_error, sizeof(_error), "%s %s : %s", _schema.name,
+             n < _schema.size ? _schema.fields[n].name : "", reason);
+    return false;
+  }
+  for (unsigned i = 0; i < n; i++)
+    _param[i] = values[i];
+  _dirty = true;
+  _error[0] = '\0';
+  return true;
 }
+
 /**
- * @brief Prints the parameter string and individual parameters to the Serial.
+ * @brief Sets the first n parameters from an array (binary storage).
  * 
- * This function prints the parameter string followed by the individual parameter
- * values, separated by commas.
+ * @param values New values, brought within the bounds of the schema.
+ * @param n Number of values, extra values are ignored.
+ */
+void SimpleParam::setValues(const int32_t* values, unsigned n) {
+  for (unsigned i = 0; i < n && i < _schema.size; i++)
+    _param[i] = clampValue(i, values[i]);
+  _dirty = true;
+}
+/**
+ * @brief Prints the individual parameters to the Serial, separated by commas.
  */
 void SimpleParam::print() {
-  //Serial.println(_sparam);
   Serial.print(_param[0]);
-  for (int i = 1; i < _nparam; i++) {
+  for (unsigned i = 1; i < _schema.size; i++) {
     Serial.print(',');
     Serial.print(_param[i]);
   }
   Serial.println();
-}
\ No newline at end of file
+}
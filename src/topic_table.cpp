@@ -0,0 +1,54 @@
+/**
+ * @file topic_table.cpp
+ * @brief Implementation de la table de répartition des messages MQTT.
+ */
+#include <ctype.h>
+#include "topic_table.h"
+
+long TopicPayload::toInt() const {
+  unsigned i = 0;
+  while (i < length && isspace((unsigned char)data[i]))
+    i++;
+  boolean negative = i < length && data[i] == '-';
+  if (i < length && (data[i] == '-' || data[i] == '+'))
+    i++;
+  long value = 0;
+  for (; i < length && data[i] >= '0' && data[i] <= '9'; i++)
+    value = value * 10 + (data[i] - '0');
+  return negative ? -value : value;
+}
+
+const char* TopicPayload::text() const {
+  static char buffer[MQTT_MAX_PACKET_SIZE];
+  if (length >= sizeof(buffer))
+    return "";
+  memcpy(buffer, data, length);
+  buffer[length] = '\0';
+  return buffer;
+}
+
+const TopicHandler* findTopic(const TopicHandler* table, size_t size, const char* topic) {
+  const size_t rootLength = sizeof(TOPIC_ROOT) - 1;
+  if (strncmp(topic, TOPIC_ROOT, rootLength) != 0)
+    return NULL;
+  topic += rootLength;
+  size_t low = 0, high = size;
+  while (low < high) {
+    size_t middle = (low + high) / 2;
+    int c = strcmp(topic, table[middle].topic + rootLength);
+    if (c == 0)
+      return &table[middle];
+    if (c < 0)
+      high = middle;
+    else
+      low = middle + 1;
+  }
+  return NULL;
+}
+
+boolean subscribeTopics(PubSubClient& client, const TopicHandler* table, size_t size) {
+  boolean ok = true;
+  for (size_t i = 0; i < size; i++)
+    ok = client.subscribe(table[i].topic) && ok;
+  return ok;
+}
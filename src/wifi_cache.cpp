@@ -0,0 +1,156 @@
+/**
+ * @file wifi_cache.cpp
+ * @brief Implementation du cache de connexion WiFi.
+ */
+#include <ESP32Time.h>
+#include "wifi_cache.h"
+#include "files.h"
+
+// Enregistrement WIFI_CACHE_FILE_NAME (voir RECORD_FORMAT_* de param_store.h)
+#define RECORD_FORMAT_WIFI_CACHE 4
+#define RTC_WIFI_MAGIC 0x3C0FF1CE
+
+/**
+ * @brief Point d'accès et bail de la dernière connexion
+ */
+struct WifiCache {
+  uint8_t bssid[6];
+  uint8_t channel;     ///< 0 : pas de point d'accès mémorisé
+  uint8_t leased;      ///< Bail DHCP mémorisé
+  uint32_t leaseTime;  ///< Date d'obtention du bail (epoch)
+  uint8_t ip[4];
+  uint8_t gateway[4];
+  uint8_t subnet[4];
+  uint8_t dns[4];
+};
+
+RTC_NOINIT_ATTR static struct {
+  uint32_t magic;
+  WifiCache cache;
+  uint32_t crc;
+} rtcWifi;
+
+static WifiCache& cache = rtcWifi.cache;
+static FileLittleFS* cacheFile;
+static WifiCacheStats stats;
+static boolean connecting;  ///< Connexion en cours depuis start
+static uint32_t start;
+static boolean direct;      ///< Tentative en cours vers le point d'accès mémorisé
+static boolean leaseUsed;   ///< Tentative en cours avec le bail mémorisé
+
+static void updateCrc() {
+  rtcWifi.magic = RTC_WIFI_MAGIC;
+  rtcWifi.crc = FileLittleFS::crc32(&rtcWifi.cache, sizeof(rtcWifi.cache));
+}
+
+static uint32_t epoch() {
+  // Horloge interne, conservée lors d'un redémarrage logiciel
+  static ESP32Time utc(0);
+  return utc.getEpoch();
+}
+
+static IPAddress address(const uint8_t* a) {
+  return IPAddress(a[0], a[1], a[2], a[3]);
+}
+
+static void copyAddress(uint8_t* a, IPAddress ip) {
+  for (int i = 0; i < 4; i++)
+    a[i] = ip[i];
+}
+
+static boolean leaseValid() {
+  uint32_t now = epoch();
+  return cache.leased && now >= cache.leaseTime && now - cache.leaseTime < WIFI_LEASE_REUSE;
+}
+
+void wifiCacheInit() {
+  cacheFile = new FileLittleFS(WIFI_CACHE_FILE_NAME);
+  if (rtcWifi.magic == RTC_WIFI_MAGIC &&
+      rtcWifi.crc == FileLittleFS::crc32(&rtcWifi.cache, sizeof(rtcWifi.cache)))
+    return;
+  // Mise sous tension : point d'accès enregistré, pas de bail
+  if (cacheFile->readRecord(RECORD_FORMAT_WIFI_CACHE, &cache, sizeof(cache)) != sizeof(cache))
+    memset(&cache, 0, sizeof(cache));
+  cache.leased = 0;
+  updateCrc();
+}
+
+boolean wifiCacheBegin(const char* ssid, const char* password) {
+  if (!connecting) {
+    connecting = true;
+    start = millis();
+  }
+  direct = cache.channel != 0;
+#ifdef WIFI_STATIC_IP
+  leaseUsed = false;
+  WiFi.config(IPAddress(WIFI_STATIC_IP), IPAddress(WIFI_STATIC_GATEWAY),
+              IPAddress(WIFI_STATIC_SUBNET), IPAddress(WIFI_STATIC_DNS));
+#else
+  leaseUsed = direct && leaseValid();
+  if (leaseUsed)
+    WiFi.config(address(cache.ip), address(cache.gateway), address(cache.subnet), address(cache.dns));
+  else
+    // Adresse nulle : DHCP
+    WiFi.config(IPAddress(), IPAddress(), IPAddress());
+#endif
+  if (direct)
+    WiFi.begin(ssid, password, cache.channel, cache.bssid);
+  else
+    WiFi.begin(ssid, password);
+  return direct;
+}
+
+void wifiCacheConnected() {
+  // Reconnexion automatique du pilote : cache seul mis à jour
+  if (connecting) {
+    connecting = false;
+    stats.lastConnect = millis() - start;
+    if (stats.direct + stats.scans == 0)
+      stats.bootConnect = stats.lastConnect;
+    if (direct)
+      stats.direct++;
+    else
+      stats.scans++;
+    stats.lastDirect = direct;
+  }
+  WifiCache current = cache;
+  const uint8_t* bssid = WiFi.BSSID();
+  if (bssid != NULL)
+    memcpy(current.bssid, bssid, sizeof(current.bssid));
+  current.channel = WiFi.channel();
+  boolean moved = memcmp(current.bssid, cache.bssid, sizeof(current.bssid)) != 0 ||
+                  current.channel != cache.channel;
+#ifndef WIFI_STATIC_IP
+  // Bail obtenu par DHCP
+  if (!leaseUsed) {
+    current.leased = 1;
+    current.leaseTime = epoch();
+    copyAddress(current.ip, WiFi.localIP());
+    copyAddress(current.gateway, WiFi.gatewayIP());
+    copyAddress(current.subnet, WiFi.subnetMask());
+    copyAddress(current.dns, WiFi.dnsIP());
+  }
+#endif
+  cache = current;
+  updateCrc();
+  // Changement de point d'accès : enregistré pour la mise sous tension
+  if (moved) {
+    current.leased = 0;
+    cacheFile->writeRecord(RECORD_FORMAT_WIFI_CACHE, &current, sizeof(current));
+  }
+}
+
+boolean wifiCacheFailed() {
+  if (!direct)
+    return false;
+  stats.directFailures++;
+  memset(&cache, 0, sizeof(cache));
+  updateCrc();
+  direct = false;
+  WiFi.disconnect();
+  return true;
+}
+
+void wifiCacheStatsTake(WifiCacheStats* copy) {
+  *copy = stats;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests du cycle de scrutation sur les registres simulés (IO_BACKEND_MOCK).
+ *
+ * L'application est démarrée (setup) sur la plateforme native, puis chaque
+ * test positionne les contacts (ioMockSetInputs), exécute des cycles de
+ * scrutation (scanCycle : sampleInputs, localLoop, ioFlush) et vérifie les
+ * relais verrouillés dans les 74HC595 (ioMockOutputs) et le nombre de
+ * verrouillages (ioMockLatchCount).
+ *
+ *   pio test -e native
+ */
+#include <Arduino.h>
+#include <unity.h>
+#include "const.h"
+#include "io.h"
+#include "scan.h"
+#include "simple_param.h"
+#include "local_loop.h"
+
+#define RELAYS_MASK 0x0FF0000
+
+/**
+ * @brief Contacts fermés pendant un cycle, puis un cycle contacts ouverts
+ *        (appui bref sur la télécommande)
+ */
+static void press(unsigned mask) {
+  ioMockSetInputs(mask);
+  scanCycle();
+  ioMockSetInputs(0);
+  scanCycle();
+}
+
+static void test_idle_cycles_do_not_latch(void) {
+  ioMockSetInputs(0);
+  scanCycle();
+  unsigned long latches = ioMockLatchCount();
+  unsigned outputs = ioMockOutputs();
+  for (int i = 0; i < 10; i++)
+    scanCycle();
+  TEST_ASSERT_EQUAL_UINT32(latches, ioMockLatchCount());
+  TEST_ASSERT_EQUAL_HEX32(outputs, ioMockOutputs());
+}
+
+static void test_tank_filling_latches_relays_once(void) {
+  unsigned long latches = ioMockLatchCount();
+  press(I_IRRIGATION);
+  TEST_ASSERT_TRUE(isTankFilling);
+  // Pompe, transformateur et électrovanne commutés ensemble (ioBegin/ioCommit)
+  TEST_ASSERT_EQUAL_HEX32(O_POMPE | O_TRANSFO | O_EV_IRRIGATION, ioMockOutputs() & (O_POMPE | O_TRANSFO | O_EV_IRRIGATION));
+  TEST_ASSERT_EQUAL_UINT32(latches + 1, ioMockLatchCount());
+
+  press(I_IRRIGATION);
+  TEST_ASSERT_FALSE(isTankFilling);
+  TEST_ASSERT_EQUAL_HEX32(0, ioMockOutputs() & (O_POMPE | O_TRANSFO | O_EV_IRRIGATION));
+  TEST_ASSERT_EQUAL_UINT32(latches + 2, ioMockLatchCount());
+}
+
+static void test_supressor_contact_drives_pump(void) {
+  cDlyParam->set(SUPRESSOR_EN, 1);
+  unsigned long latches = ioMockLatchCount();
+  unsigned others = ioMockOutputs() & RELAYS_MASK & ~O_POMPE;
+
+  ioMockSetInputs(I_SURPRESSEUR);
+  scanCycle();
+  TEST_ASSERT_TRUE(ioMockOutputs() & O_POMPE);
+  TEST_ASSERT_EQUAL_UINT32(latches + 1, ioMockLatchCount());
+  // Contact toujours fermé : pas de nouvelle écriture des registres
+  scanCycle();
+  TEST_ASSERT_EQUAL_UINT32(latches + 1, ioMockLatchCount());
+
+  ioMockSetInputs(0);
+  scanCycle();
+  TEST_ASSERT_FALSE(ioMockOutputs() & O_POMPE);
+  TEST_ASSERT_EQUAL_HEX32(others, ioMockOutputs() & RELAYS_MASK);
+  TEST_ASSERT_EQUAL_UINT32(latches + 2, ioMockLatchCount());
+}
+
+int main() {
+  ioMockSetInputs(0);
+  setup();
+  UNITY_BEGIN();
+  RUN_TEST(test_idle_cycles_do_not_latch);
+  RUN_TEST(test_tank_filling_latches_relays_once);
+  RUN_TEST(test_supressor_contact_drives_pump);
+  return UNITY_END();
+}
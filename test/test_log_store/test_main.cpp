@@ -0,0 +1,177 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests du journal circulaire segmenté (LogStore) sur le système de
+ *        fichiers en mémoire de la plateforme native.
+ *
+ * Chaque enregistrement porte son numéro d'ordre dans ses données, ce qui
+ * permet de vérifier que read() rend exactement les enregistrements conservés,
+ * dans l'ordre. Un redémarrage est simulé par un nouveau LogStore relisant les
+ * segments (begin), une coupure pendant l'écriture en tronquant un segment
+ * (LittleFS.halFiles/halSetFiles).
+ *
+ *   pio test -e native
+ */
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include "const.h"
+#include "log_store.h"
+
+// Données de 100 octets : 18 enregistrements de 108 octets par segment
+#define RECORD_SIZE 100
+#define RECORDS_PER_SEGMENT (LOG_SEGMENT_SIZE / (sizeof(LogHeader) + RECORD_SIZE))
+
+/**
+ * @brief Enregistrements relus par read()
+ */
+struct Collected {
+  uint32_t seq[LOG_SEGMENTS * RECORDS_PER_SEGMENT];
+  int count;
+  boolean valid;  ///< Données, taille et type conformes à l'enregistrement écrit
+};
+
+static void fill(uint8_t* data, uint32_t value) {
+  memset(data, (uint8_t)value, RECORD_SIZE);
+  memcpy(data, &value, sizeof(value));
+}
+
+static uint32_t add(LogStore* logs, uint32_t value) {
+  uint8_t data[RECORD_SIZE];
+  fill(data, value);
+  return logs->append(data, sizeof(data), LOG_TYPE_EVENT);
+}
+
+static void collect(uint32_t seq, uint8_t type, const uint8_t* data, size_t size, void* context) {
+  auto* collected = (Collected*)context;
+  uint8_t expected[RECORD_SIZE];
+  fill(expected, seq);
+  if (type != LOG_TYPE_EVENT || size != RECORD_SIZE || memcmp(data, expected, size) != 0)
+    collected->valid = false;
+  if (collected->count < (int)(sizeof(collected->seq) / sizeof(collected->seq[0])))
+    collected->seq[collected->count] = seq;
+  collected->count++;
+}
+
+/**
+ * @brief Relit le journal à partir de from et vérifie les numéros first..last
+ *        et la valeur retournée par read()
+ */
+static void readExpect(LogStore* logs, uint32_t from, uint32_t first, uint32_t last, uint32_t next) {
+  Collected collected;
+  collected.count = 0;
+  collected.valid = true;
+  TEST_ASSERT_EQUAL_UINT32(next, logs->read(from, collect, &collected));
+  TEST_ASSERT_TRUE(collected.valid);
+  TEST_ASSERT_EQUAL_INT(last + 1 - first, collected.count);
+  for (int i = 0; i < collected.count; i++)
+    TEST_ASSERT_EQUAL_UINT32(first + i, collected.seq[i]);
+}
+
+/**
+ * @brief Journal relu depuis la mémoire flash (redémarrage)
+ */
+static LogStore* reboot() {
+  auto* logs = new LogStore();
+  logs->begin(false);
+  return logs;
+}
+
+static LogStore* empty() {
+  LittleFS.halSetFiles({});
+  return reboot();
+}
+
+static String segmentName(int segment) {
+  char name[16];
+  snprintf(name, sizeof(name), LOG_SEGMENT_NAME, segment);
+  return String(name);
+}
+
+static void test_wrap_keeps_last_segments(void) {
+  LogStore* logs = empty();
+  // 10 segments écrits : les segments 0 et 1 ont été réutilisés
+  uint32_t total = 10 * RECORDS_PER_SEGMENT;
+  for (uint32_t i = 1; i <= total; i++)
+    TEST_ASSERT_EQUAL_UINT32(i, add(logs, i));
+  TEST_ASSERT_EQUAL_UINT32(total + 1, logs->nextSeq());
+  uint32_t oldest = total - LOG_SEGMENTS * RECORDS_PER_SEGMENT + 1;
+  readExpect(logs, 0, oldest, total, total + 1);
+}
+
+static void test_read_from_selects_segment(void) {
+  LogStore* logs = empty();
+  uint32_t total = 10 * RECORDS_PER_SEGMENT;
+  for (uint32_t i = 1; i <= total; i++)
+    add(logs, i);
+  uint32_t oldest = total - LOG_SEGMENTS * RECORDS_PER_SEGMENT + 1;
+  // Premier, milieu et dernier enregistrement d'un segment, segment courant
+  uint32_t froms[] = { oldest + RECORDS_PER_SEGMENT, oldest + RECORDS_PER_SEGMENT + 7,
+                       oldest + 2 * RECORDS_PER_SEGMENT - 1, total - 1 };
+  for (uint32_t from : froms)
+    readExpect(logs, from, from, total, total + 1);
+  // Numéro perdu (segment réutilisé) : à partir du plus ancien
+  readExpect(logs, oldest - 5, oldest, total, total + 1);
+  // Journal déjà reçu en entier
+  readExpect(logs, total + 1, 1, 0, total + 1);
+}
+
+static void test_read_from_after_next_restarts(void) {
+  LogStore* logs = empty();
+  for (uint32_t i = 1; i <= 5; i++)
+    add(logs, i);
+  // Numéro reçu d'un journal antérieur, effacé depuis : tout relire
+  readExpect(logs, 1000, 1, 5, 6);
+}
+
+static void test_begin_restores_head_and_next(void) {
+  LogStore* logs = empty();
+  uint32_t total = 9 * RECORDS_PER_SEGMENT + 3;
+  for (uint32_t i = 1; i <= total; i++)
+    add(logs, i);
+  size_t head = LittleFS.halFiles()[segmentName(1).c_str()].size();
+
+  logs = reboot();
+  TEST_ASSERT_EQUAL_UINT32(total + 1, logs->nextSeq());
+  // L'écriture se poursuit dans le segment courant
+  TEST_ASSERT_EQUAL_UINT32(total + 1, add(logs, total + 1));
+  TEST_ASSERT_EQUAL_UINT(head + sizeof(LogHeader) + RECORD_SIZE,
+                         LittleFS.halFiles()[segmentName(1).c_str()].size());
+  uint32_t oldest = 2 * RECORDS_PER_SEGMENT + 1;
+  readExpect(logs, 0, oldest, total + 1, total + 2);
+}
+
+static void test_torn_record_starts_new_segment(void) {
+  LogStore* logs = empty();
+  uint32_t total = 2 * RECORDS_PER_SEGMENT + 3;
+  for (uint32_t i = 1; i <= total; i++)
+    add(logs, i);
+  // Coupure pendant l'écriture du dernier enregistrement du segment 2
+  auto files = LittleFS.halFiles();
+  std::string& head = files[segmentName(2).c_str()];
+  head.resize(head.size() - RECORD_SIZE / 2);
+  LittleFS.halSetFiles(files);
+
+  logs = reboot();
+  TEST_ASSERT_EQUAL_UINT32(total, logs->nextSeq());
+  TEST_ASSERT_EQUAL_UINT32(total, add(logs, total));
+  // Segment tronqué laissé tel quel, enregistrement écrit dans le segment 3
+  files = LittleFS.halFiles();
+  TEST_ASSERT_EQUAL_UINT(head.size(), files[segmentName(2).c_str()].size());
+  TEST_ASSERT_EQUAL_UINT(sizeof(LogHeader) + RECORD_SIZE, files[segmentName(3).c_str()].size());
+  readExpect(logs, 0, 1, total, total + 1);
+
+  // Nouveau redémarrage : le segment 3 est bien le segment courant
+  logs = reboot();
+  TEST_ASSERT_EQUAL_UINT32(total + 1, logs->nextSeq());
+  readExpect(logs, total - 1, total - 1, total, total + 1);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_wrap_keeps_last_segments);
+  RUN_TEST(test_read_from_selects_segment);
+  RUN_TEST(test_read_from_after_next_restarts);
+  RUN_TEST(test_begin_restores_head_and_next);
+  RUN_TEST(test_torn_record_starts_new_segment);
+  return UNITY_END();
+}
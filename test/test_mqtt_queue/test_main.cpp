@@ -0,0 +1,172 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests de la file des publications MQTT (mqttPublish, mqttQueueDrain).
+ *
+ * Les messages sont publiés sur le client MQTT de la plateforme native ;
+ * le crochet halMqttOnPublish relève les publications dans l'ordre. Les
+ * compteurs (mqttQueueStatsTake) sont cumulés depuis le démarrage : chaque
+ * test compare leur évolution.
+ *
+ *   pio test -e native
+ */
+#include <Arduino.h>
+#include <WiFi.h>
+#include <PubSubClient.h>
+#include <unity.h>
+#include "const.h"
+#include "mqtt_queue.h"
+
+#define MAX_PUBLISHED (2 * MQTT_QUEUE_SIZE)
+
+/**
+ * @brief Publications relevées par le crochet du client
+ */
+static struct {
+  const char* topic[MAX_PUBLISHED];
+  char payload[MAX_PUBLISHED][MQTT_QUEUE_PAYLOAD];
+  int count;
+} published;
+
+static PubSubClient client;
+
+static void onPublish(const char* topic, const char* payload) {
+  if (published.count < MAX_PUBLISHED) {
+    published.topic[published.count] = topic;
+    strncpy(published.payload[published.count], payload, MQTT_QUEUE_PAYLOAD - 1);
+  }
+  published.count++;
+}
+
+static void drain() {
+  published.count = 0;
+  mqttQueueDrain(client);
+}
+
+static void expectPublished(int i, const char* topic, const char* payload) {
+  TEST_ASSERT_EQUAL_STRING(topic, published.topic[i]);
+  TEST_ASSERT_EQUAL_STRING(payload, published.payload[i]);
+}
+
+/**
+ * @brief Client connecté, file vide
+ */
+static void connect() {
+  WiFi.halSetConnected(true);
+  client.connect("test");
+  drain();
+}
+
+static void test_status_value_replaced_in_place(void) {
+  connect();
+  MqttQueueStats before, after;
+  mqttQueueStatsTake(&before);
+  TEST_ASSERT_TRUE(mqttPublish(TOPIC_STATUS_VMC, "1"));
+  TEST_ASSERT_TRUE(mqttPublish(TOPIC_PAC_IR_ON, ""));
+  TEST_ASSERT_TRUE(mqttPublish(TOPIC_STATUS_VMC, "2"));
+  // Topic identique mais chaine différente
+  char topic[64];
+  strcpy(topic, TOPIC_STATUS_VMC);
+  TEST_ASSERT_TRUE(mqttPublish(topic, "3"));
+  mqttQueueStatsTake(&after);
+  TEST_ASSERT_EQUAL_UINT32(before.queued + 2, after.queued);
+  TEST_ASSERT_EQUAL_UINT32(before.coalesced + 2, after.coalesced);
+  TEST_ASSERT_EQUAL_UINT32(2, after.pending);
+
+  drain();
+  TEST_ASSERT_EQUAL_INT(2, published.count);
+  expectPublished(0, TOPIC_STATUS_VMC, "3");
+  expectPublished(1, TOPIC_PAC_IR_ON, "");
+  mqttQueueStatsTake(&after);
+  TEST_ASSERT_EQUAL_UINT32(before.published + 2, after.published);
+  TEST_ASSERT_EQUAL_UINT32(0, after.pending);
+}
+
+static void test_events_published_in_order(void) {
+  connect();
+  MqttQueueStats before, after;
+  mqttQueueStatsTake(&before);
+  mqttPublish(SUB_GPIO0_ACTION, "on");
+  mqttPublish(TOPIC_STATUS_PAC, "1");
+  mqttPublish(SUB_GPIO0_ACTION, "off");
+  mqttPublish(SUB_GPIO0_ACTION, "on");
+  drain();
+  TEST_ASSERT_EQUAL_INT(4, published.count);
+  expectPublished(0, SUB_GPIO0_ACTION, "on");
+  expectPublished(1, TOPIC_STATUS_PAC, "1");
+  expectPublished(2, SUB_GPIO0_ACTION, "off");
+  expectPublished(3, SUB_GPIO0_ACTION, "on");
+  mqttQueueStatsTake(&after);
+  TEST_ASSERT_EQUAL_UINT32(before.coalesced, after.coalesced);
+}
+
+static void test_full_queue_drops_events(void) {
+  connect();
+  MqttQueueStats before, after;
+  mqttQueueStatsTake(&before);
+  TEST_ASSERT_TRUE(mqttPublish(TOPIC_STATUS_CUISINE, "0"));
+  for (int i = 1; i < MQTT_QUEUE_SIZE; i++)
+    TEST_ASSERT_TRUE(mqttPublish(TOPIC_PAC_IR_OFF, ""));
+  TEST_ASSERT_FALSE(mqttPublish(TOPIC_PAC_IR_ON, ""));
+  TEST_ASSERT_FALSE(mqttPublish(TOPIC_STATUS_PAC, "1"));
+  // Valeur d'état en attente : remplacée même file pleine
+  TEST_ASSERT_TRUE(mqttPublish(TOPIC_STATUS_CUISINE, "1"));
+  mqttQueueStatsTake(&after);
+  TEST_ASSERT_EQUAL_UINT32(before.dropped + 2, after.dropped);
+  TEST_ASSERT_EQUAL_UINT32(MQTT_QUEUE_SIZE, after.maxDepth);
+  TEST_ASSERT_EQUAL_UINT32(MQTT_QUEUE_SIZE, after.pending);
+
+  drain();
+  TEST_ASSERT_EQUAL_INT(MQTT_QUEUE_SIZE, published.count);
+  expectPublished(0, TOPIC_STATUS_CUISINE, "1");
+  expectPublished(MQTT_QUEUE_SIZE - 1, TOPIC_PAC_IR_OFF, "");
+}
+
+static void test_long_payload_dropped(void) {
+  connect();
+  MqttQueueStats before, after;
+  char payload[MQTT_QUEUE_PAYLOAD + 1];
+  memset(payload, 'x', MQTT_QUEUE_PAYLOAD);
+  payload[MQTT_QUEUE_PAYLOAD] = '\0';
+  mqttQueueStatsTake(&before);
+  TEST_ASSERT_FALSE(mqttPublish(TOPIC_NEXT_EVENT, payload));
+  // Le plus long contenu accepté
+  payload[MQTT_QUEUE_PAYLOAD - 1] = '\0';
+  TEST_ASSERT_TRUE(mqttPublish(TOPIC_NEXT_EVENT, payload));
+  mqttQueueStatsTake(&after);
+  TEST_ASSERT_EQUAL_UINT32(before.dropped + 1, after.dropped);
+  drain();
+  TEST_ASSERT_EQUAL_INT(1, published.count);
+  expectPublished(0, TOPIC_NEXT_EVENT, payload);
+}
+
+static void test_disconnected_client_keeps_messages(void) {
+  connect();
+  mqttPublish(TOPIC_GPIO, "1");
+  mqttPublish(TOPIC_PAC_IR_ON, "");
+  WiFi.halSetConnected(false);
+  drain();
+  TEST_ASSERT_EQUAL_INT(0, published.count);
+  // Nouvelle valeur pendant la coupure
+  mqttPublish(TOPIC_GPIO, "0");
+  MqttQueueStats stats;
+  mqttQueueStatsTake(&stats);
+  TEST_ASSERT_EQUAL_UINT32(2, stats.pending);
+
+  WiFi.halSetConnected(true);
+  client.connect("test");
+  drain();
+  TEST_ASSERT_EQUAL_INT(2, published.count);
+  expectPublished(0, TOPIC_GPIO, "0");
+  expectPublished(1, TOPIC_PAC_IR_ON, "");
+}
+
+int main() {
+  halMqttOnPublish = onPublish;
+  UNITY_BEGIN();
+  RUN_TEST(test_status_value_replaced_in_place);
+  RUN_TEST(test_events_published_in_order);
+  RUN_TEST(test_full_queue_drops_events);
+  RUN_TEST(test_long_payload_dropped);
+  RUN_TEST(test_disconnected_client_keeps_messages);
+  return UNITY_END();
+}
@@ -0,0 +1,176 @@
+/**
+ * @file test_main.cpp
+ * @brief Tests de l'analyse des plages horaires (Param::setStr, Param::setParam).
+ *
+ * La chaine "enable:HMin:MMin:HMax:MMax:..." (N_PARAM plages) est validée en
+ * une passe : une chaine invalide est refusée avec un message (error()) et
+ * les plages courantes sont conservées.
+ *
+ *   pio test -e native
+ */
+#include <Arduino.h>
+#include <unity.h>
+#include "const.h"
+#include "param.h"
+
+#define PARAM_SIZE (TAILLE_PLAGE * N_PARAM + 2)
+
+/**
+ * @brief Chaine des plages : plage i = (i % 2):HH:MM:HH:MM dérivée de i
+ */
+static void build(char* str) {
+  char* p = str;
+  for (int i = 0; i < N_PARAM; i++)
+    p += sprintf(p, "%d:%02d:%02d:%02d:%02d:", i % 2, i % 24, (i * 3) % 60, (i + 1) % 24, (i * 7) % 60);
+  p[-1] = '\0';
+}
+
+/**
+ * @brief Remplace le champ field (0..N_FIELDS-1) de la plage i
+ *        Les plages suivantes sont décalées si la taille change.
+ */
+static void replaceField(char* str, int i, int field, const char* value) {
+  char* p = str + i * TAILLE_PLAGE + (field ? 3 * field - 1 : 0);
+  int length = field ? 2 : 1;
+  memmove(p + strlen(value), p + length, strlen(p + length) + 1);
+  memcpy(p, value, strlen(value));
+}
+
+static void expectRange(Param* param, int device, int range, int enable, int hMin, int mMin, int hMax, int mMax) {
+  ItemParam item = param->get(device, range);
+  TEST_ASSERT_EQUAL_INT(enable, item.enable);
+  TEST_ASSERT_EQUAL_INT(hMin, item.HMin);
+  TEST_ASSERT_EQUAL_INT(mMin, item.MMin);
+  TEST_ASSERT_EQUAL_INT(hMax, item.HMax);
+  TEST_ASSERT_EQUAL_INT(mMax, item.MMax);
+}
+
+static void test_valid_string_is_parsed(void) {
+  char str[PARAM_SIZE];
+  build(str);
+  Param param(str);
+  TEST_ASSERT_NULL(param.error());
+  for (int i = 0; i < N_PARAM; i++)
+    expectRange(&param, i / N_PLAGES, i % N_PLAGES, i % 2, i % 24, (i * 3) % 60, (i + 1) % 24, (i * 7) % 60);
+  TEST_ASSERT_EQUAL_STRING(str, param.getStr());
+}
+
+static void test_string_is_normalized(void) {
+  char str[PARAM_SIZE], expected[PARAM_SIZE];
+  build(expected);
+  // Un seul chiffre, ':' final et fin de ligne acceptés
+  build(str);
+  replaceField(str, 2, 1, "2");
+  replaceField(str, 1, 2, "3");
+  strcat(str, ":\r\n");
+  Param param("");
+  TEST_ASSERT_TRUE(param.setStr(str));
+  TEST_ASSERT_EQUAL_STRING(expected, param.getStr());
+}
+
+static void test_invalid_fields_are_rejected(void) {
+  char valid[PARAM_SIZE];
+  build(valid);
+  Param param(valid);
+  unsigned version = param.version();
+  struct { int range; int field; const char* value; const char* error; } cases[] = {
+    { 0, 0, "3", "Param dev 0 plage 0 enable : hors limites" },
+    { 1, 1, "24", "Param dev 0 plage 1 HMin : hors limites" },
+    { 6, 2, "60", "Param dev 1 plage 2 MMin : hors limites" },
+    { 9, 3, "24", "Param dev 2 plage 1 HMax : hors limites" },
+    { 19, 4, "60", "Param dev 4 plage 3 MMax : hors limites" },
+    { 3, 1, "123", "Param dev 0 plage 3 HMin : trop de chiffres" },
+    { 4, 2, "x", "Param dev 1 plage 0 MMin : nombre attendu" },
+  };
+  for (auto& c : cases) {
+    char str[PARAM_SIZE + 4];
+    strcpy(str, valid);
+    replaceField(str, c.range, c.field, c.value);
+    TEST_ASSERT_FALSE(param.setStr(str));
+    TEST_ASSERT_EQUAL_STRING(c.error, param.error());
+    TEST_ASSERT_EQUAL_STRING(valid, param.getStr());
+    TEST_ASSERT_EQUAL_UINT(version, param.version());
+  }
+}
+
+static void test_malformed_strings_are_rejected(void) {
+  char valid[PARAM_SIZE], str[PARAM_SIZE + 4];
+  build(valid);
+  Param param(valid);
+  // Séparateur manquant
+  strcpy(str, valid);
+  str[TAILLE_PLAGE + 4] = '-';
+  TEST_ASSERT_FALSE(param.setStr(str));
+  TEST_ASSERT_EQUAL_STRING("Param dev 0 plage 1 MMin : ':' attendu", param.error());
+  // Chaine incomplète
+  strcpy(str, valid);
+  str[strlen(str) - 3] = '\0';
+  TEST_ASSERT_FALSE(param.setStr(str));
+  TEST_ASSERT_NOT_NULL(param.error());
+  // Caractères en trop
+  strcpy(str, valid);
+  strcat(str, ":1");
+  TEST_ASSERT_FALSE(param.setStr(str));
+  TEST_ASSERT_NOT_NULL(param.error());
+  TEST_ASSERT_EQUAL_STRING(valid, param.getStr());
+  // Erreur effacée par une chaine valide
+  TEST_ASSERT_TRUE(param.setStr(valid));
+  TEST_ASSERT_NULL(param.error());
+}
+
+static void test_circuit2_days_allowed_for_irrigation(void) {
+  char str[PARAM_SIZE];
+  build(str);
+  int range = IRRIGATION * N_PLAGES + 1;
+  char days[4];
+  snprintf(days, sizeof(days), "%02d", MAX_DAYS_CIRCUIT2);
+  replaceField(str, range, 3, days);
+  replaceField(str, range, 4, days);
+  Param param(str);
+  TEST_ASSERT_NULL(param.error());
+  ItemParam item = param.get(IRRIGATION, 1);
+  TEST_ASSERT_EQUAL_INT(MAX_DAYS_CIRCUIT2, item.HMax);
+  TEST_ASSERT_EQUAL_INT(MAX_DAYS_CIRCUIT2, item.MMax);
+  // Limite des heures pour les autres équipements
+  build(str);
+  replaceField(str, 1, 3, days);
+  TEST_ASSERT_FALSE(param.setStr(str));
+}
+
+static void test_set_param_parses_current_string(void) {
+  char str[PARAM_SIZE];
+  build(str);
+  Param param(str);
+  ItemParam item;
+  item.enable = 1;
+  item.HMin = 6;
+  item.MMin = 30;
+  item.HMax = 7;
+  item.MMax = 15;
+  unsigned version = param.version();
+  param.set(2, 3, item);
+  TEST_ASSERT_EQUAL_UINT(version + 1, param.version());
+  // Plage inchangée : pas de nouvelle version
+  param.set(2, 3, item);
+  TEST_ASSERT_EQUAL_UINT(version + 1, param.version());
+  replaceField(str, 2 * N_PLAGES + 3, 0, "1");
+  replaceField(str, 2 * N_PLAGES + 3, 1, "06");
+  replaceField(str, 2 * N_PLAGES + 3, 2, "30");
+  replaceField(str, 2 * N_PLAGES + 3, 3, "07");
+  replaceField(str, 2 * N_PLAGES + 3, 4, "15");
+  TEST_ASSERT_EQUAL_STRING(str, param.getStr());
+  TEST_ASSERT_TRUE(param.setParam());
+  expectRange(&param, 2, 3, 1, 6, 30, 7, 15);
+  TEST_ASSERT_EQUAL_STRING(str, param.getStr());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_valid_string_is_parsed);
+  RUN_TEST(test_string_is_normalized);
+  RUN_TEST(test_invalid_fields_are_rejected);
+  RUN_TEST(test_malformed_strings_are_rejected);
+  RUN_TEST(test_circuit2_days_allowed_for_irrigation);
+  RUN_TEST(test_set_param_parses_current_string);
+  return UNITY_END();
+}